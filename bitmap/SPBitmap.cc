@@ -154,9 +154,17 @@ static void _makeBitmapWriter(BitmapWriter &w, BitmapStdTarget *target,
 template <>
 bool BitmapTemplate<memory::PoolInterface>::loadData(const uint8_t *data, size_t dataLen,
 		const StrideFn &strideFn) {
+	return decodeData(data, dataLen, 0, 0, strideFn);
+}
+
+template <>
+bool BitmapTemplate<memory::PoolInterface>::decodeData(const uint8_t *data, size_t dataLen,
+		uint32_t targetWidth, uint32_t targetHeight, const StrideFn &strideFn) {
 	BitmapPoolTarget target{&_data, strideFn ? &strideFn : nullptr};
 	BitmapWriter w;
 	_makeBitmapWriter(w, &target, *this);
+	w.targetWidth = targetWidth;
+	w.targetHeight = targetHeight;
 	auto ret = _loadData(w, data, dataLen);
 	if (!ret.second.empty()) {
 		_color = w.color;
@@ -174,9 +182,17 @@ bool BitmapTemplate<memory::PoolInterface>::loadData(const uint8_t *data, size_t
 template <>
 bool BitmapTemplate<memory::StandartInterface>::loadData(const uint8_t *data, size_t dataLen,
 		const StrideFn &strideFn) {
+	return decodeData(data, dataLen, 0, 0, strideFn);
+}
+
+template <>
+bool BitmapTemplate<memory::StandartInterface>::decodeData(const uint8_t *data, size_t dataLen,
+		uint32_t targetWidth, uint32_t targetHeight, const StrideFn &strideFn) {
 	BitmapStdTarget target{&_data, strideFn ? &strideFn : nullptr};
 	BitmapWriter w;
 	_makeBitmapWriter(w, &target, *this);
+	w.targetWidth = targetWidth;
+	w.targetHeight = targetHeight;
 	auto ret = _loadData(w, data, dataLen);
 	if (!ret.second.empty()) {
 		_color = w.color;
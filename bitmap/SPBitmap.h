@@ -28,6 +28,12 @@ THE SOFTWARE.
 #include "SPBitmapFormat.h"
 #include "SPFilepath.h"
 
+namespace STAPPLER_VERSIONIZED stappler::thread {
+
+class ThreadPool;
+
+}
+
 namespace STAPPLER_VERSIONIZED stappler::bitmap {
 
 enum class ResampleFilter {
@@ -96,16 +102,30 @@ public:
 
 	bool updateStride(const StrideFn &strideFn);
 	bool convert(PixelFormat, const StrideFn &strideFn = nullptr);
+
+	// convert pixel format and premultiply or unpremultiply alpha in single pass
+	bool convert(PixelFormat, AlphaFormat, const StrideFn &strideFn = nullptr);
 	bool truncate(PixelFormat, const StrideFn &strideFn = nullptr);
 
 	// target should be large enough
 	size_t convertWithTarget(uint8_t *target, PixelFormat,
 			const StrideFn &strideFn = nullptr) const;
+	size_t convertWithTarget(uint8_t *target, PixelFormat, AlphaFormat,
+			const StrideFn &strideFn = nullptr) const;
 
 	// init with jpeg or png data
 	bool loadData(const uint8_t *data, size_t dataLen, const StrideFn &strideFn = nullptr);
 	bool loadData(BytesView, const StrideFn &strideFn = nullptr);
 
+	// init with jpeg, png, webp or another formatted data, resulting bitmap is
+	// targetWidth x targetHeight (zero dimension is derived from image aspect ratio)
+	// JPEG and WebP are decoded at reduced size when possible, then resampled;
+	// bitmap is not modified on failure
+	bool loadData(const uint8_t *data, size_t dataLen, uint32_t targetWidth,
+			uint32_t targetHeight, const StrideFn &strideFn = nullptr);
+	bool loadData(BytesView, uint32_t targetWidth, uint32_t targetHeight,
+			const StrideFn &strideFn = nullptr);
+
 	// init with raw data
 	void loadBitmap(const uint8_t *d, uint32_t w, uint32_t h, PixelFormat = PixelFormat::RGBA8888,
 			AlphaFormat a = AlphaFormat::Unpremultiplied, uint32_t stride = 0);
@@ -144,7 +164,15 @@ public:
 	BitmapTemplate resample(ResampleFilter, uint32_t width, uint32_t height,
 			uint32_t stride = 0) const;
 
+	// rows are split between the calling thread and pool's workers
+	// (requires stappler_threads module, otherwise pool is ignored)
+	BitmapTemplate resample(ResampleFilter, uint32_t width, uint32_t height, uint32_t stride,
+			thread::ThreadPool *) const;
+
 protected:
+	bool decodeData(const uint8_t *data, size_t dataLen, uint32_t targetWidth,
+			uint32_t targetHeight, const StrideFn &strideFn);
+
 	void setInfo(uint32_t w, uint32_t h, PixelFormat c,
 			AlphaFormat a = AlphaFormat::Unpremultiplied, uint32_t stride = 0);
 
@@ -354,6 +382,45 @@ bool BitmapTemplate<Interface>::convert(PixelFormat color, const StrideFn &strid
 	return ret;
 }
 
+template <typename Interface>
+bool BitmapTemplate<Interface>::convert(PixelFormat color, AlphaFormat alpha,
+		const StrideFn &strideFn) {
+	if (color == PixelFormat::Auto) {
+		color = _color;
+	}
+
+	auto op = getAlphaOp(_alpha, alpha);
+	if (_color == color && op == AlphaOp::None) {
+		_alpha = alpha;
+		return updateStride(strideFn);
+	}
+
+	uint32_t outStride = (strideFn != nullptr)
+			? max(strideFn(color, _width), _width * getBytesPerPixel(color))
+			: _width * getBytesPerPixel(color);
+
+	if (_color == color && _stride == outStride) {
+		// only alpha changed, convert in place
+		convertImage(_data.data(), _stride, _color, _data.data(), _stride, _color, _width, _height,
+				op);
+		_alpha = alpha;
+		return true;
+	}
+
+	typename Interface::BytesType out;
+	out.resize(_height * outStride);
+
+	if (convertWithTarget(out.data(), color, alpha, strideFn)) {
+		_color = color;
+		_alpha = alpha;
+		_data = sp::move(out);
+		_stride = outStride;
+		return true;
+	}
+
+	return false;
+}
+
 template <typename Interface>
 bool BitmapTemplate<Interface>::truncate(PixelFormat color, const StrideFn &strideFn) {
 	if (color == PixelFormat::Auto) {
@@ -401,137 +468,22 @@ bool BitmapTemplate<Interface>::truncate(PixelFormat color, const StrideFn &stri
 template <typename Interface>
 size_t BitmapTemplate<Interface>::convertWithTarget(uint8_t *target, PixelFormat color,
 		const StrideFn &strideFn) const {
+	return convertWithTarget(target, color, _alpha, strideFn);
+}
+
+template <typename Interface>
+size_t BitmapTemplate<Interface>::convertWithTarget(uint8_t *target, PixelFormat color,
+		AlphaFormat alpha, const StrideFn &strideFn) const {
+	if (color == PixelFormat::Auto) {
+		color = _color;
+	}
+
 	uint32_t outStride = (strideFn != nullptr)
 			? max(strideFn(color, _width), _width * getBytesPerPixel(color))
 			: _width * getBytesPerPixel(color);
-	BytesView out(target, _height * outStride);
-
-	switch (_color) {
-	case PixelFormat::A8:
-		switch (color) {
-		case PixelFormat::A8:
-			memcpy(target, _data.data(), out.size());
-			return out.size();
-			break;
-		case PixelFormat::I8:
-			memcpy(target, _data.data(), out.size());
-			return out.size();
-			break;
-		case PixelFormat::IA88:
-			return convertData<PixelFormat::A8, PixelFormat::IA88>(_data, out, _stride, outStride);
-			break;
-		case PixelFormat::RGB888:
-			return convertData<PixelFormat::A8, PixelFormat::RGB888>(_data, out, _stride,
-					outStride);
-			break;
-		case PixelFormat::RGBA8888:
-			return convertData<PixelFormat::A8, PixelFormat::RGBA8888>(_data, out, _stride,
-					outStride);
-			break;
-		case PixelFormat::Auto: return 0; break;
-		}
-		break;
-	case PixelFormat::I8:
-		switch (color) {
-		case PixelFormat::A8:
-			memcpy(target, _data.data(), out.size());
-			return out.size();
-			break;
-		case PixelFormat::I8:
-			memcpy(target, _data.data(), out.size());
-			return out.size();
-			break;
-		case PixelFormat::IA88:
-			return convertData<PixelFormat::I8, PixelFormat::IA88>(_data, out, _stride, outStride);
-			break;
-		case PixelFormat::RGB888:
-			return convertData<PixelFormat::I8, PixelFormat::RGB888>(_data, out, _stride,
-					outStride);
-			break;
-		case PixelFormat::RGBA8888:
-			return convertData<PixelFormat::I8, PixelFormat::RGBA8888>(_data, out, _stride,
-					outStride);
-			break;
-		case PixelFormat::Auto: return 0; break;
-		}
-		break;
-	case PixelFormat::IA88:
-		switch (color) {
-		case PixelFormat::A8:
-			return convertData<PixelFormat::IA88, PixelFormat::A8>(_data, out, _stride, outStride);
-			break;
-		case PixelFormat::I8:
-			return convertData<PixelFormat::IA88, PixelFormat::I8>(_data, out, _stride, outStride);
-			break;
-		case PixelFormat::IA88:
-			memcpy(target, _data.data(), out.size());
-			return out.size();
-			break;
-		case PixelFormat::RGB888:
-			return convertData<PixelFormat::IA88, PixelFormat::RGB888>(_data, out, _stride,
-					outStride);
-			break;
-		case PixelFormat::RGBA8888:
-			return convertData<PixelFormat::IA88, PixelFormat::RGBA8888>(_data, out, _stride,
-					outStride);
-			break;
-		case PixelFormat::Auto: return 0; break;
-		}
-		break;
-	case PixelFormat::RGB888:
-		switch (color) {
-		case PixelFormat::A8:
-			return convertData<PixelFormat::RGB888, PixelFormat::A8>(_data, out, _stride,
-					outStride);
-			break;
-		case PixelFormat::I8:
-			return convertData<PixelFormat::RGB888, PixelFormat::I8>(_data, out, _stride,
-					outStride);
-			break;
-		case PixelFormat::IA88:
-			return convertData<PixelFormat::RGB888, PixelFormat::IA88>(_data, out, _stride,
-					outStride);
-			break;
-		case PixelFormat::RGB888:
-			memcpy(target, _data.data(), out.size());
-			return out.size();
-			break;
-		case PixelFormat::RGBA8888:
-			return convertData<PixelFormat::RGB888, PixelFormat::RGBA8888>(_data, out, _stride,
-					outStride);
-			break;
-		case PixelFormat::Auto: return 0; break;
-		}
-		break;
-	case PixelFormat::RGBA8888:
-		switch (color) {
-		case PixelFormat::A8:
-			return convertData<PixelFormat::RGBA8888, PixelFormat::A8>(_data, out, _stride,
-					outStride);
-			break;
-		case PixelFormat::I8:
-			return convertData<PixelFormat::RGBA8888, PixelFormat::I8>(_data, out, _stride,
-					outStride);
-			break;
-		case PixelFormat::IA88:
-			return convertData<PixelFormat::RGBA8888, PixelFormat::IA88>(_data, out, _stride,
-					outStride);
-			break;
-		case PixelFormat::RGB888:
-			return convertData<PixelFormat::RGBA8888, PixelFormat::RGB888>(_data, out, _stride,
-					outStride);
-			break;
-		case PixelFormat::RGBA8888:
-			memcpy(target, _data.data(), out.size());
-			return out.size();
-			break;
-		case PixelFormat::Auto: return 0; break;
-		}
-		break;
-	case PixelFormat::Auto: return 0; break;
-	}
 
-	return 0;
+	return convertImage(_data.data(), _stride, _color, target, outStride, color, _width, _height,
+			getAlphaOp(_alpha, alpha));
 }
 
 template <typename Interface>
@@ -553,6 +505,50 @@ bool BitmapTemplate<Interface>::loadData(BytesView d, const StrideFn &strideFn)
 	return loadData(d.data(), d.size(), strideFn);
 }
 
+template <typename Interface>
+bool BitmapTemplate<Interface>::loadData(const uint8_t *data, size_t dataLen,
+		uint32_t targetWidth, uint32_t targetHeight, const StrideFn &strideFn) {
+	// decode into temporary, so bitmap is not modified on failure
+	// (current format is kept as a hint for grayscale images, as with loadData)
+	BitmapTemplate<Interface> decoded;
+	decoded._color = _color;
+	decoded._alpha = _alpha;
+	if (!decoded.decodeData(data, dataLen, targetWidth, targetHeight, strideFn)) {
+		return false;
+	}
+
+	if (targetWidth == 0 && targetHeight == 0) {
+		*this = sp::move(decoded);
+		return true;
+	} else if (targetWidth == 0) {
+		targetWidth = max(uint32_t(uint64_t(decoded._width) * targetHeight / decoded._height),
+				uint32_t(1));
+	} else if (targetHeight == 0) {
+		targetHeight = max(uint32_t(uint64_t(decoded._height) * targetWidth / decoded._width),
+				uint32_t(1));
+	}
+
+	if (decoded._width == targetWidth && decoded._height == targetHeight) {
+		*this = sp::move(decoded);
+		return true;
+	}
+
+	auto ret = decoded.resample(targetWidth, targetHeight,
+			strideFn ? strideFn(decoded._color, targetWidth) : 0);
+	if (ret.empty()) {
+		return false;
+	}
+
+	*this = sp::move(ret);
+	return true;
+}
+
+template <typename Interface>
+bool BitmapTemplate<Interface>::loadData(BytesView d, uint32_t targetWidth,
+		uint32_t targetHeight, const StrideFn &strideFn) {
+	return loadData(d.data(), d.size(), targetWidth, targetHeight, strideFn);
+}
+
 } // namespace stappler::bitmap
 
 namespace STAPPLER_VERSIONIZED stappler::mem_std {
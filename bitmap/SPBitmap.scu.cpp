@@ -74,5 +74,7 @@ SPUNUSED static const std::vector<BitmapFormat *> &getCustomFormats() {
 }
 
 #include "SPBitmapFormat.cc"
+#include "SPBitmapConvert.cc"
 #include "SPBitmap.cc"
 #include "SPBitmapResample.cc"
+#include "SPBitmapStream.cc"
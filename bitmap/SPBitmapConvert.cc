@@ -0,0 +1,495 @@
+/**
+ Copyright (c) 2025 Stappler LLC <admin@stappler.dev>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ **/
+
+#include "SPBitmapFormat.h"
+
+namespace STAPPLER_VERSIONIZED stappler::bitmap {
+
+// Conversion kernels operates on pixel count within row and never touches stride padding.
+// Loops are written without cross-iteration dependencies on restrict pointers,
+// so compiler can vectorize them with target's native SIMD.
+
+// Rows are processed in blocks, so alpha pass works on data, that is still in L1
+static constexpr uint32_t ConvertBlockSize = 256;
+
+#define SP_BITMAP_RESTRICT __restrict__
+
+static constexpr uint8_t Convert_luminance(uint32_t r, uint32_t g, uint32_t b) {
+	return uint8_t((r * 299 + g * 587 + b * 114 + 500) / 1000);
+}
+
+template <PixelFormat Source, PixelFormat Target>
+struct ConvertKernel;
+
+template <PixelFormat Format>
+struct ConvertKernel<Format, Format> {
+	static void run(const uint8_t *SP_BITMAP_RESTRICT in, uint8_t *SP_BITMAP_RESTRICT out,
+			uint32_t width) {
+		memcpy(out, in, width * getBytesPerPixel(Format));
+	}
+};
+
+template <>
+struct ConvertKernel<PixelFormat::A8, PixelFormat::I8> {
+	static void run(const uint8_t *SP_BITMAP_RESTRICT in, uint8_t *SP_BITMAP_RESTRICT out,
+			uint32_t width) {
+		memcpy(out, in, width);
+	}
+};
+
+template <>
+struct ConvertKernel<PixelFormat::A8, PixelFormat::IA88> {
+	static void run(const uint8_t *SP_BITMAP_RESTRICT in, uint8_t *SP_BITMAP_RESTRICT out,
+			uint32_t width) {
+		for (uint32_t i = 0; i < width; ++i) {
+			out[i * 2] = 0xFF;
+			out[i * 2 + 1] = in[i];
+		}
+	}
+};
+
+template <>
+struct ConvertKernel<PixelFormat::A8, PixelFormat::RGB888> {
+	static void run(const uint8_t *SP_BITMAP_RESTRICT in, uint8_t *SP_BITMAP_RESTRICT out,
+			uint32_t width) {
+		memset(out, 0, width * 3);
+	}
+};
+
+template <>
+struct ConvertKernel<PixelFormat::A8, PixelFormat::RGBA8888> {
+	static void run(const uint8_t *SP_BITMAP_RESTRICT in, uint8_t *SP_BITMAP_RESTRICT out,
+			uint32_t width) {
+		for (uint32_t i = 0; i < width; ++i) {
+			out[i * 4] = 0;
+			out[i * 4 + 1] = 0;
+			out[i * 4 + 2] = 0;
+			out[i * 4 + 3] = in[i];
+		}
+	}
+};
+
+template <>
+struct ConvertKernel<PixelFormat::I8, PixelFormat::A8> {
+	static void run(const uint8_t *SP_BITMAP_RESTRICT in, uint8_t *SP_BITMAP_RESTRICT out,
+			uint32_t width) {
+		memcpy(out, in, width);
+	}
+};
+
+template <>
+struct ConvertKernel<PixelFormat::I8, PixelFormat::IA88> {
+	static void run(const uint8_t *SP_BITMAP_RESTRICT in, uint8_t *SP_BITMAP_RESTRICT out,
+			uint32_t width) {
+		for (uint32_t i = 0; i < width; ++i) {
+			out[i * 2] = in[i];
+			out[i * 2 + 1] = 0xFF;
+		}
+	}
+};
+
+template <>
+struct ConvertKernel<PixelFormat::I8, PixelFormat::RGB888> {
+	static void run(const uint8_t *SP_BITMAP_RESTRICT in, uint8_t *SP_BITMAP_RESTRICT out,
+			uint32_t width) {
+		for (uint32_t i = 0; i < width; ++i) {
+			out[i * 3] = in[i];
+			out[i * 3 + 1] = in[i];
+			out[i * 3 + 2] = in[i];
+		}
+	}
+};
+
+template <>
+struct ConvertKernel<PixelFormat::I8, PixelFormat::RGBA8888> {
+	static void run(const uint8_t *SP_BITMAP_RESTRICT in, uint8_t *SP_BITMAP_RESTRICT out,
+			uint32_t width) {
+		for (uint32_t i = 0; i < width; ++i) {
+			out[i * 4] = in[i];
+			out[i * 4 + 1] = in[i];
+			out[i * 4 + 2] = in[i];
+			out[i * 4 + 3] = 0xFF;
+		}
+	}
+};
+
+template <>
+struct ConvertKernel<PixelFormat::IA88, PixelFormat::A8> {
+	static void run(const uint8_t *SP_BITMAP_RESTRICT in, uint8_t *SP_BITMAP_RESTRICT out,
+			uint32_t width) {
+		for (uint32_t i = 0; i < width; ++i) { out[i] = in[i * 2 + 1]; }
+	}
+};
+
+template <>
+struct ConvertKernel<PixelFormat::IA88, PixelFormat::I8> {
+	static void run(const uint8_t *SP_BITMAP_RESTRICT in, uint8_t *SP_BITMAP_RESTRICT out,
+			uint32_t width) {
+		for (uint32_t i = 0; i < width; ++i) { out[i] = in[i * 2]; }
+	}
+};
+
+template <>
+struct ConvertKernel<PixelFormat::IA88, PixelFormat::RGB888> {
+	static void run(const uint8_t *SP_BITMAP_RESTRICT in, uint8_t *SP_BITMAP_RESTRICT out,
+			uint32_t width) {
+		for (uint32_t i = 0; i < width; ++i) {
+			out[i * 3] = in[i * 2];
+			out[i * 3 + 1] = in[i * 2];
+			out[i * 3 + 2] = in[i * 2];
+		}
+	}
+};
+
+template <>
+struct ConvertKernel<PixelFormat::IA88, PixelFormat::RGBA8888> {
+	static void run(const uint8_t *SP_BITMAP_RESTRICT in, uint8_t *SP_BITMAP_RESTRICT out,
+			uint32_t width) {
+		for (uint32_t i = 0; i < width; ++i) {
+			out[i * 4] = in[i * 2];
+			out[i * 4 + 1] = in[i * 2];
+			out[i * 4 + 2] = in[i * 2];
+			out[i * 4 + 3] = in[i * 2 + 1];
+		}
+	}
+};
+
+template <>
+struct ConvertKernel<PixelFormat::RGB888, PixelFormat::A8> {
+	static void run(const uint8_t *SP_BITMAP_RESTRICT in, uint8_t *SP_BITMAP_RESTRICT out,
+			uint32_t width) {
+		memset(out, 0, width);
+	}
+};
+
+template <>
+struct ConvertKernel<PixelFormat::RGB888, PixelFormat::I8> {
+	static void run(const uint8_t *SP_BITMAP_RESTRICT in, uint8_t *SP_BITMAP_RESTRICT out,
+			uint32_t width) {
+		for (uint32_t i = 0; i < width; ++i) {
+			out[i] = Convert_luminance(in[i * 3], in[i * 3 + 1], in[i * 3 + 2]);
+		}
+	}
+};
+
+template <>
+struct ConvertKernel<PixelFormat::RGB888, PixelFormat::IA88> {
+	static void run(const uint8_t *SP_BITMAP_RESTRICT in, uint8_t *SP_BITMAP_RESTRICT out,
+			uint32_t width) {
+		for (uint32_t i = 0; i < width; ++i) {
+			out[i * 2] = Convert_luminance(in[i * 3], in[i * 3 + 1], in[i * 3 + 2]);
+			out[i * 2 + 1] = 0xFF;
+		}
+	}
+};
+
+template <>
+struct ConvertKernel<PixelFormat::RGB888, PixelFormat::RGBA8888> {
+	static void run(const uint8_t *SP_BITMAP_RESTRICT in, uint8_t *SP_BITMAP_RESTRICT out,
+			uint32_t width) {
+		for (uint32_t i = 0; i < width; ++i) {
+			out[i * 4] = in[i * 3];
+			out[i * 4 + 1] = in[i * 3 + 1];
+			out[i * 4 + 2] = in[i * 3 + 2];
+			out[i * 4 + 3] = 0xFF;
+		}
+	}
+};
+
+template <>
+struct ConvertKernel<PixelFormat::RGBA8888, PixelFormat::A8> {
+	static void run(const uint8_t *SP_BITMAP_RESTRICT in, uint8_t *SP_BITMAP_RESTRICT out,
+			uint32_t width) {
+		for (uint32_t i = 0; i < width; ++i) { out[i] = in[i * 4 + 3]; }
+	}
+};
+
+template <>
+struct ConvertKernel<PixelFormat::RGBA8888, PixelFormat::I8> {
+	static void run(const uint8_t *SP_BITMAP_RESTRICT in, uint8_t *SP_BITMAP_RESTRICT out,
+			uint32_t width) {
+		for (uint32_t i = 0; i < width; ++i) {
+			out[i] = Convert_luminance(in[i * 4], in[i * 4 + 1], in[i * 4 + 2]);
+		}
+	}
+};
+
+template <>
+struct ConvertKernel<PixelFormat::RGBA8888, PixelFormat::IA88> {
+	static void run(const uint8_t *SP_BITMAP_RESTRICT in, uint8_t *SP_BITMAP_RESTRICT out,
+			uint32_t width) {
+		for (uint32_t i = 0; i < width; ++i) {
+			out[i * 2] = Convert_luminance(in[i * 4], in[i * 4 + 1], in[i * 4 + 2]);
+			out[i * 2 + 1] = in[i * 4 + 3];
+		}
+	}
+};
+
+template <>
+struct ConvertKernel<PixelFormat::RGBA8888, PixelFormat::RGB888> {
+	static void run(const uint8_t *SP_BITMAP_RESTRICT in, uint8_t *SP_BITMAP_RESTRICT out,
+			uint32_t width) {
+		for (uint32_t i = 0; i < width; ++i) {
+			out[i * 3] = in[i * 4];
+			out[i * 3 + 1] = in[i * 4 + 1];
+			out[i * 3 + 2] = in[i * 4 + 2];
+		}
+	}
+};
+
+// c * a / 255 with correct rounding, exact for all 8-bit inputs
+static constexpr uint8_t Convert_premultiply(uint32_t c, uint32_t a) {
+	auto t = c * a + 128;
+	return uint8_t((t + (t >> 8)) >> 8);
+}
+
+// (c * 255 + a / 2) / a, clamped to 255, zero alpha gives zero color
+// division is replaced with 8.24 fixed-point reciprocal, exact for all 8-bit inputs
+struct ConvertUnpremultiplyTable {
+	uint32_t values[256];
+
+	constexpr ConvertUnpremultiplyTable() : values() {
+		values[0] = 0;
+		for (uint32_t a = 1; a < 256; ++a) { values[a] = ((1U << 24) + a - 1) / a; }
+	}
+};
+
+static constexpr ConvertUnpremultiplyTable s_unpremultiplyTable;
+
+static constexpr uint8_t Convert_unpremultiply(uint32_t c, uint32_t a) {
+	auto v = uint32_t((uint64_t(c * 255 + a / 2) * s_unpremultiplyTable.values[a]) >> 24);
+	return uint8_t(v > 255 ? 255 : v);
+}
+
+// Round-trip invariants of conversion kernels, checked at compile time for all 8-bit inputs:
+// - premultiply is c * a / 255 with correct rounding
+// - unpremultiply is (c * 255 + a / 2) / a for valid premultiplied colors (c <= a)
+// - premultiplied -> unpremultiplied -> premultiplied is lossless
+// - unpremultiply restores opaque colors
+// - gray -> RGB -> gray is lossless
+static constexpr bool Convert_checkAlphaInvariants(uint32_t first, uint32_t last) {
+	for (uint32_t a = first; a < last; ++a) {
+		for (uint32_t c = 0; c < 256; ++c) {
+			if (Convert_premultiply(c, a) != (c * a + 127) / 255) {
+				return false;
+			}
+			if (c <= a) {
+				auto u = (a == 0) ? 0 : (c * 255 + a / 2) / a;
+				if (Convert_unpremultiply(c, a) != ((u > 255) ? 255 : u)) {
+					return false;
+				}
+				if (Convert_premultiply(Convert_unpremultiply(c, a), a) != c) {
+					return false;
+				}
+			}
+			if (a == 255 && Convert_unpremultiply(Convert_premultiply(c, a), a) != c) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+static constexpr bool Convert_checkLuminanceInvariants() {
+	for (uint32_t v = 0; v < 256; ++v) {
+		if (Convert_luminance(v, v, v) != v) {
+			return false;
+		}
+	}
+	return true;
+}
+
+// split by alpha ranges to stay within compiler's constexpr evaluation limits
+static_assert(Convert_checkAlphaInvariants(0, 32), "Invalid alpha conversion");
+static_assert(Convert_checkAlphaInvariants(32, 64), "Invalid alpha conversion");
+static_assert(Convert_checkAlphaInvariants(64, 96), "Invalid alpha conversion");
+static_assert(Convert_checkAlphaInvariants(96, 128), "Invalid alpha conversion");
+static_assert(Convert_checkAlphaInvariants(128, 160), "Invalid alpha conversion");
+static_assert(Convert_checkAlphaInvariants(160, 192), "Invalid alpha conversion");
+static_assert(Convert_checkAlphaInvariants(192, 224), "Invalid alpha conversion");
+static_assert(Convert_checkAlphaInvariants(224, 256), "Invalid alpha conversion");
+static_assert(Convert_checkLuminanceInvariants(), "Invalid luminance conversion");
+
+template <PixelFormat Format, AlphaOp Op>
+struct AlphaKernel {
+	static void run(uint8_t *data, uint32_t width) { }
+};
+
+template <>
+struct AlphaKernel<PixelFormat::IA88, AlphaOp::Premultiply> {
+	static void run(uint8_t *SP_BITMAP_RESTRICT data, uint32_t width) {
+		for (uint32_t i = 0; i < width; ++i) {
+			data[i * 2] = Convert_premultiply(data[i * 2], data[i * 2 + 1]);
+		}
+	}
+};
+
+template <>
+struct AlphaKernel<PixelFormat::RGBA8888, AlphaOp::Premultiply> {
+	static void run(uint8_t *SP_BITMAP_RESTRICT data, uint32_t width) {
+		for (uint32_t i = 0; i < width; ++i) {
+			auto a = data[i * 4 + 3];
+			data[i * 4] = Convert_premultiply(data[i * 4], a);
+			data[i * 4 + 1] = Convert_premultiply(data[i * 4 + 1], a);
+			data[i * 4 + 2] = Convert_premultiply(data[i * 4 + 2], a);
+		}
+	}
+};
+
+template <>
+struct AlphaKernel<PixelFormat::IA88, AlphaOp::Unpremultiply> {
+	static void run(uint8_t *SP_BITMAP_RESTRICT data, uint32_t width) {
+		for (uint32_t i = 0; i < width; ++i) {
+			data[i * 2] = Convert_unpremultiply(data[i * 2], data[i * 2 + 1]);
+		}
+	}
+};
+
+template <>
+struct AlphaKernel<PixelFormat::RGBA8888, AlphaOp::Unpremultiply> {
+	static void run(uint8_t *SP_BITMAP_RESTRICT data, uint32_t width) {
+		for (uint32_t i = 0; i < width; ++i) {
+			auto a = data[i * 4 + 3];
+			data[i * 4] = Convert_unpremultiply(data[i * 4], a);
+			data[i * 4 + 1] = Convert_unpremultiply(data[i * 4 + 1], a);
+			data[i * 4 + 2] = Convert_unpremultiply(data[i * 4 + 2], a);
+		}
+	}
+};
+
+template <PixelFormat Source, PixelFormat Target, AlphaOp Op>
+static void Convert_line(const uint8_t *in, uint8_t *out, uint32_t width) {
+	if constexpr (Op == AlphaOp::None || Target == PixelFormat::A8 || Target == PixelFormat::I8
+			|| Target == PixelFormat::RGB888) {
+		ConvertKernel<Source, Target>::run(in, out, width);
+	} else {
+		constexpr auto inBpp = getBytesPerPixel(Source);
+		constexpr auto outBpp = getBytesPerPixel(Target);
+		while (width > 0) {
+			auto count = min(width, ConvertBlockSize);
+			if constexpr (Source != Target) {
+				ConvertKernel<Source, Target>::run(in, out, count);
+			} else if (in != out) {
+				ConvertKernel<Source, Target>::run(in, out, count);
+			}
+			AlphaKernel<Target, Op>::run(out, count);
+			in += count * inBpp;
+			out += count * outBpp;
+			width -= count;
+		}
+	}
+}
+
+template <PixelFormat Source, PixelFormat Target>
+static constexpr ConvertLineFn Convert_getFn(AlphaOp op) {
+	switch (op) {
+	case AlphaOp::None: return &Convert_line<Source, Target, AlphaOp::None>; break;
+	case AlphaOp::Premultiply: return &Convert_line<Source, Target, AlphaOp::Premultiply>; break;
+	case AlphaOp::Unpremultiply:
+		return &Convert_line<Source, Target, AlphaOp::Unpremultiply>;
+		break;
+	}
+	return nullptr;
+}
+
+template <PixelFormat Source>
+static constexpr ConvertLineFn Convert_getFn(PixelFormat target, AlphaOp op) {
+	switch (target) {
+	case PixelFormat::A8: return Convert_getFn<Source, PixelFormat::A8>(op); break;
+	case PixelFormat::I8: return Convert_getFn<Source, PixelFormat::I8>(op); break;
+	case PixelFormat::IA88: return Convert_getFn<Source, PixelFormat::IA88>(op); break;
+	case PixelFormat::RGB888: return Convert_getFn<Source, PixelFormat::RGB888>(op); break;
+	case PixelFormat::RGBA8888: return Convert_getFn<Source, PixelFormat::RGBA8888>(op); break;
+	case PixelFormat::Auto: break;
+	}
+	return nullptr;
+}
+
+static constexpr ConvertLineFn Convert_getFn(PixelFormat source, PixelFormat target, AlphaOp op) {
+	if (source == PixelFormat::I8 || source == PixelFormat::RGB888) {
+		op = AlphaOp::None; // source is opaque, alpha op is no-op
+	}
+
+	switch (source) {
+	case PixelFormat::A8: return Convert_getFn<PixelFormat::A8>(target, op); break;
+	case PixelFormat::I8: return Convert_getFn<PixelFormat::I8>(target, op); break;
+	case PixelFormat::IA88: return Convert_getFn<PixelFormat::IA88>(target, op); break;
+	case PixelFormat::RGB888: return Convert_getFn<PixelFormat::RGB888>(target, op); break;
+	case PixelFormat::RGBA8888: return Convert_getFn<PixelFormat::RGBA8888>(target, op); break;
+	case PixelFormat::Auto: break;
+	}
+	return nullptr;
+}
+
+struct ConvertKernelTable {
+	static constexpr size_t FormatCount = toInt(PixelFormat::RGBA8888) + 1;
+	static constexpr size_t OpCount = toInt(AlphaOp::Unpremultiply) + 1;
+
+	ConvertLineFn kernels[FormatCount][FormatCount][OpCount];
+
+	constexpr ConvertKernelTable() : kernels() {
+		for (size_t s = 0; s < FormatCount; ++s) {
+			for (size_t t = 0; t < FormatCount; ++t) {
+				for (size_t op = 0; op < OpCount; ++op) {
+					kernels[s][t][op] = Convert_getFn(PixelFormat(s), PixelFormat(t), AlphaOp(op));
+				}
+			}
+		}
+	}
+};
+
+static constexpr ConvertKernelTable s_convertKernels;
+
+ConvertLineFn getConvertLineFn(PixelFormat source, PixelFormat target, AlphaOp op) {
+	return s_convertKernels.kernels[toInt(source)][toInt(target)][toInt(op)];
+}
+
+AlphaOp getAlphaOp(AlphaFormat source, AlphaFormat target) {
+	if (source == AlphaFormat::Unpremultiplied && target == AlphaFormat::Premultiplied) {
+		return AlphaOp::Premultiply;
+	} else if (source == AlphaFormat::Premultiplied && target == AlphaFormat::Unpremultiplied) {
+		return AlphaOp::Unpremultiply;
+	}
+	return AlphaOp::None;
+}
+
+size_t convertImage(const uint8_t *in, uint32_t inStride, PixelFormat source, uint8_t *out,
+		uint32_t outStride, PixelFormat target, uint32_t width, uint32_t height, AlphaOp op) {
+	auto fn = getConvertLineFn(source, target, op);
+	if (!fn) {
+		return 0;
+	}
+
+	// single pass for tightly packed data
+	if (inStride == width * getBytesPerPixel(source)
+			&& outStride == width * getBytesPerPixel(target)) {
+		fn(in, out, width * height);
+		return outStride * height;
+	}
+
+	for (uint32_t j = 0; j < height; ++j) { fn(in + inStride * j, out + outStride * j, width); }
+	return outStride * height;
+}
+
+#undef SP_BITMAP_RESTRICT
+
+} // namespace stappler::bitmap
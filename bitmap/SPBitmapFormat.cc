@@ -344,148 +344,132 @@ bool check(StringView name, const uint8_t * data, size_t dataLen) {
 	return false;
 }
 
-template<>
-void convertLine<PixelFormat::RGB888, PixelFormat::RGBA8888>(const uint8_t *in, uint8_t *out, uint32_t ins, uint32_t outs) {
-	for (size_t i = 0, l = ins - 2; i < l; i += 3) {
-		*out++ = in[i];			//R
-		*out++ = in[i + 1];		//G
-		*out++ = in[i + 2];		//B
-		*out++ = 0xFF;			//A
-	}
+// line converters are kept for compatibility, see SPBitmapConvert.cc for kernels
+
+template <>
+void convertLine<PixelFormat::RGB888, PixelFormat::RGBA8888>(const uint8_t *in, uint8_t *out,
+		uint32_t ins, uint32_t outs) {
+	getConvertLineFn(PixelFormat::RGB888, PixelFormat::RGBA8888)(in, out,
+			ins / getBytesPerPixel(PixelFormat::RGB888));
 }
 
-template<>
-void convertLine<PixelFormat::I8, PixelFormat::RGB888>(const uint8_t *in, uint8_t *out, uint32_t ins, uint32_t outs) {
-    for (size_t i = 0; i < ins; ++i) {
-        *out++ = in[i];     //R
-        *out++ = in[i];     //G
-        *out++ = in[i];     //B
-    }
+template <>
+void convertLine<PixelFormat::I8, PixelFormat::RGB888>(const uint8_t *in, uint8_t *out,
+		uint32_t ins, uint32_t outs) {
+	getConvertLineFn(PixelFormat::I8, PixelFormat::RGB888)(in, out,
+			ins / getBytesPerPixel(PixelFormat::I8));
 }
 
-template<>
-void convertLine<PixelFormat::IA88, PixelFormat::RGB888>(const uint8_t *in, uint8_t *out, uint32_t ins, uint32_t outs) {
-    for (size_t i = 0, l = ins - 1; i < l; i += 2) {
-        *out++ = in[i];     //R
-        *out++ = in[i];     //G
-        *out++ = in[i];     //B
-    }
+template <>
+void convertLine<PixelFormat::IA88, PixelFormat::RGB888>(const uint8_t *in, uint8_t *out,
+		uint32_t ins, uint32_t outs) {
+	getConvertLineFn(PixelFormat::IA88, PixelFormat::RGB888)(in, out,
+			ins / getBytesPerPixel(PixelFormat::IA88));
 }
 
-template<>
-void convertLine<PixelFormat::I8, PixelFormat::RGBA8888>(const uint8_t *in, uint8_t *out, uint32_t ins, uint32_t outs) {
-	for (size_t i = 0; i < ins; ++i) {
-        *out++ = in[i];     //R
-        *out++ = in[i];     //G
-        *out++ = in[i];     //B
-        *out++ = 0xFF;      //A
-    }
-}
+template <>
+void convertLine<PixelFormat::I8, PixelFormat::RGBA8888>(const uint8_t *in, uint8_t *out,
+		uint32_t ins, uint32_t outs) {
+	getConvertLineFn(PixelFormat::I8, PixelFormat::RGBA8888)(in, out,
+			ins / getBytesPerPixel(PixelFormat::I8));
+}
 
-template<>
-void convertLine<PixelFormat::IA88, PixelFormat::RGBA8888>(const uint8_t *in, uint8_t *out, uint32_t ins, uint32_t outs) {
-    for (size_t i = 0, l = ins - 1; i < l; i += 2) {
-        *out++ = in[i];     //R
-        *out++ = in[i];     //G
-        *out++ = in[i];     //B
-        *out++ = in[i + 1]; //A
-    }
+template <>
+void convertLine<PixelFormat::IA88, PixelFormat::RGBA8888>(const uint8_t *in, uint8_t *out,
+		uint32_t ins, uint32_t outs) {
+	getConvertLineFn(PixelFormat::IA88, PixelFormat::RGBA8888)(in, out,
+			ins / getBytesPerPixel(PixelFormat::IA88));
 }
 
-template<>
-void convertLine<PixelFormat::I8, PixelFormat::IA88>(const uint8_t *in, uint8_t *out, uint32_t ins, uint32_t outs) {
-    for (size_t i = 0; i < ins; ++i) {
-        *out++ = in[i];
-		*out++ = 0xFF;
-    }
+template <>
+void convertLine<PixelFormat::I8, PixelFormat::IA88>(const uint8_t *in, uint8_t *out,
+		uint32_t ins, uint32_t outs) {
+	getConvertLineFn(PixelFormat::I8, PixelFormat::IA88)(in, out,
+			ins / getBytesPerPixel(PixelFormat::I8));
 }
 
-template<>
-void convertLine<PixelFormat::IA88, PixelFormat::A8>(const uint8_t *in, uint8_t *out, uint32_t ins, uint32_t outs) {
-    for (size_t i = 1; i < ins; i += 2) {
-        *out++ = in[i]; //A
-    }
+template <>
+void convertLine<PixelFormat::IA88, PixelFormat::A8>(const uint8_t *in, uint8_t *out,
+		uint32_t ins, uint32_t outs) {
+	getConvertLineFn(PixelFormat::IA88, PixelFormat::A8)(in, out,
+			ins / getBytesPerPixel(PixelFormat::IA88));
 }
 
-template<>
-void convertLine<PixelFormat::IA88, PixelFormat::I8>(const uint8_t *in, uint8_t *out, uint32_t ins, uint32_t outs) {
-    for (size_t i = 0, l = ins - 1; i < l; i += 2) {
-        *out++ = in[i]; //R
-    }
+template <>
+void convertLine<PixelFormat::IA88, PixelFormat::I8>(const uint8_t *in, uint8_t *out,
+		uint32_t ins, uint32_t outs) {
+	getConvertLineFn(PixelFormat::IA88, PixelFormat::I8)(in, out,
+			ins / getBytesPerPixel(PixelFormat::IA88));
 }
 
-template<>
-void convertLine<PixelFormat::RGBA8888, PixelFormat::RGB888>(const uint8_t *in, uint8_t *out, uint32_t ins, uint32_t outs) {
-    for (size_t i = 0, l = ins - 3; i < l; i += 4) {
-        *out++ = in[i];         //R
-        *out++ = in[i + 1];     //G
-        *out++ = in[i + 2];     //B
-    }
+template <>
+void convertLine<PixelFormat::RGBA8888, PixelFormat::RGB888>(const uint8_t *in, uint8_t *out,
+		uint32_t ins, uint32_t outs) {
+	getConvertLineFn(PixelFormat::RGBA8888, PixelFormat::RGB888)(in, out,
+			ins / getBytesPerPixel(PixelFormat::RGBA8888));
 }
 
-template<>
-void convertLine<PixelFormat::RGB888, PixelFormat::I8>(const uint8_t *in, uint8_t *out, uint32_t ins, uint32_t outs) {
-    for (size_t i = 0, l = ins - 2; i < l; i += 3) {
-        *out++ = (in[i] * 299 + in[i + 1] * 587 + in[i + 2] * 114 + 500) / 1000;  //I =  (R*299 + G*587 + B*114 + 500) / 1000
-    }
+template <>
+void convertLine<PixelFormat::RGB888, PixelFormat::I8>(const uint8_t *in, uint8_t *out,
+		uint32_t ins, uint32_t outs) {
+	getConvertLineFn(PixelFormat::RGB888, PixelFormat::I8)(in, out,
+			ins / getBytesPerPixel(PixelFormat::RGB888));
 }
 
-template<>
-void convertLine<PixelFormat::RGBA8888, PixelFormat::I8>(const uint8_t *in, uint8_t *out, uint32_t ins, uint32_t outs) {
-    for (size_t i = 0, l = ins - 3; i < l; i += 4) {
-        *out++ = (in[i] * 299 + in[i + 1] * 587 + in[i + 2] * 114 + 500) / 1000;  //I =  (R*299 + G*587 + B*114 + 500) / 1000
-    }
+template <>
+void convertLine<PixelFormat::RGBA8888, PixelFormat::I8>(const uint8_t *in, uint8_t *out,
+		uint32_t ins, uint32_t outs) {
+	getConvertLineFn(PixelFormat::RGBA8888, PixelFormat::I8)(in, out,
+			ins / getBytesPerPixel(PixelFormat::RGBA8888));
 }
 
-template<>
-void convertLine<PixelFormat::RGBA8888, PixelFormat::A8>(const uint8_t *in, uint8_t *out, uint32_t ins, uint32_t outs) {
-    for (size_t i = 0, l = ins -3; i < l; i += 4) {
-        *out++ = in[i + 3]; //A
-    }
+template <>
+void convertLine<PixelFormat::RGBA8888, PixelFormat::A8>(const uint8_t *in, uint8_t *out,
+		uint32_t ins, uint32_t outs) {
+	getConvertLineFn(PixelFormat::RGBA8888, PixelFormat::A8)(in, out,
+			ins / getBytesPerPixel(PixelFormat::RGBA8888));
 }
 
-template<>
-void convertLine<PixelFormat::RGB888, PixelFormat::IA88>(const uint8_t *in, uint8_t *out, uint32_t ins, uint32_t outs) {
-    for (size_t i = 0, l = ins - 2; i < l; i += 3) {
-        *out++ = (in[i] * 299 + in[i + 1] * 587 + in[i + 2] * 114 + 500) / 1000;  //I =  (R*299 + G*587 + B*114 + 500) / 1000
-        *out++ = 0xFF;
-    }
+template <>
+void convertLine<PixelFormat::RGB888, PixelFormat::IA88>(const uint8_t *in, uint8_t *out,
+		uint32_t ins, uint32_t outs) {
+	getConvertLineFn(PixelFormat::RGB888, PixelFormat::IA88)(in, out,
+			ins / getBytesPerPixel(PixelFormat::RGB888));
 }
 
-template<>
-void convertLine<PixelFormat::RGBA8888, PixelFormat::IA88>(const uint8_t *in, uint8_t *out, uint32_t ins, uint32_t outs) {
-    for (size_t i = 0, l = ins - 3; i < l; i += 4) {
-        *out++ = (in[i] * 299 + in[i + 1] * 587 + in[i + 2] * 114 + 500) / 1000;  //I =  (R*299 + G*587 + B*114 + 500) / 1000
-        *out++ = in[i + 3];
-    }
+template <>
+void convertLine<PixelFormat::RGBA8888, PixelFormat::IA88>(const uint8_t *in, uint8_t *out,
+		uint32_t ins, uint32_t outs) {
+	getConvertLineFn(PixelFormat::RGBA8888, PixelFormat::IA88)(in, out,
+			ins / getBytesPerPixel(PixelFormat::RGBA8888));
 }
 
-template<>
-void convertLine<PixelFormat::A8, PixelFormat::IA88>(const uint8_t *in, uint8_t *out, uint32_t ins, uint32_t outs) {
-    for (size_t i = 0; i < ins; ++i) {
-        *out++ = 0xFF;
-        *out++ = in[i];
-    }
+template <>
+void convertLine<PixelFormat::A8, PixelFormat::IA88>(const uint8_t *in, uint8_t *out,
+		uint32_t ins, uint32_t outs) {
+	getConvertLineFn(PixelFormat::A8, PixelFormat::IA88)(in, out,
+			ins / getBytesPerPixel(PixelFormat::A8));
 }
 
-template<>
-void convertLine<PixelFormat::A8, PixelFormat::RGB888>(const uint8_t *in, uint8_t *out, uint32_t ins, uint32_t outs) {
-	memset(out, 0, outs);
+template <>
+void convertLine<PixelFormat::A8, PixelFormat::RGB888>(const uint8_t *in, uint8_t *out,
+		uint32_t ins, uint32_t outs) {
+	getConvertLineFn(PixelFormat::A8, PixelFormat::RGB888)(in, out,
+			ins / getBytesPerPixel(PixelFormat::A8));
 }
 
-template<>
-void convertLine<PixelFormat::A8, PixelFormat::RGBA8888>(const uint8_t *in, uint8_t *out, uint32_t ins, uint32_t outs) {
-    for (size_t i = 0; i < ins; ++i) {
-        *out++ = 0x00;
-        *out++ = 0x00;
-        *out++ = 0x00;
-        *out++ = in[i];
-    }
+template <>
+void convertLine<PixelFormat::A8, PixelFormat::RGBA8888>(const uint8_t *in, uint8_t *out,
+		uint32_t ins, uint32_t outs) {
+	getConvertLineFn(PixelFormat::A8, PixelFormat::RGBA8888)(in, out,
+			ins / getBytesPerPixel(PixelFormat::A8));
 }
 
-template<>
-void convertLine<PixelFormat::RGB888, PixelFormat::A8>(const uint8_t *in, uint8_t *out, uint32_t ins, uint32_t outs) {
-	memset(out, 0, outs);
+template <>
+void convertLine<PixelFormat::RGB888, PixelFormat::A8>(const uint8_t *in, uint8_t *out,
+		uint32_t ins, uint32_t outs) {
+	getConvertLineFn(PixelFormat::RGB888, PixelFormat::A8)(in, out,
+			ins / getBytesPerPixel(PixelFormat::RGB888));
 }
 
 }
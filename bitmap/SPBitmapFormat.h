@@ -89,7 +89,7 @@ SP_PUBLIC StringView getMimeType(StringView);
 SP_PUBLIC bool check(FileFormat, const uint8_t *data, size_t dataLen);
 SP_PUBLIC bool check(StringView, const uint8_t *data, size_t dataLen);
 
-inline uint8_t getBytesPerPixel(PixelFormat c) {
+constexpr inline uint8_t getBytesPerPixel(PixelFormat c) {
 	switch (c) {
 	case PixelFormat::A8: return 1; break;
 	case PixelFormat::I8: return 1; break;
@@ -101,6 +101,27 @@ inline uint8_t getBytesPerPixel(PixelFormat c) {
 	return 0;
 }
 
+enum class AlphaOp {
+	None,
+	Premultiply,
+	Unpremultiply,
+};
+
+// converts `width` pixels from source to target format, stride padding is not touched
+using ConvertLineFn = void (*)(const uint8_t *in, uint8_t *out, uint32_t width);
+
+// returns conversion kernel for (source, target, alpha op), or nullptr for PixelFormat::Auto
+// Alpha op is applied to target with alpha channel (IA88, RGBA8888), otherwise ignored
+SP_PUBLIC ConvertLineFn getConvertLineFn(PixelFormat source, PixelFormat target,
+		AlphaOp = AlphaOp::None);
+
+SP_PUBLIC AlphaOp getAlphaOp(AlphaFormat source, AlphaFormat target);
+
+// converts image with strides, returns number of bytes written (outStride * height)
+SP_PUBLIC size_t convertImage(const uint8_t *in, uint32_t inStride, PixelFormat source,
+		uint8_t *out, uint32_t outStride, PixelFormat target, uint32_t width, uint32_t height,
+		AlphaOp = AlphaOp::None);
+
 template <PixelFormat Source, PixelFormat Target>
 SP_PUBLIC void convertLine(const uint8_t *in, uint8_t *out, uint32_t ins, uint32_t outs);
 
@@ -121,6 +142,11 @@ size_t convertData(BytesView dataVec, BytesView out, uint32_t inStride, uint32_t
 struct BitmapWriter : ImageInfo {
 	void *target;
 
+	// size hint: decoders with native downscaling (JPEG DCT scaling, WebP scaler)
+	// may produce smaller image, but not smaller then target in any dimension
+	uint32_t targetWidth = 0;
+	uint32_t targetHeight = 0;
+
 	uint32_t (*getStride)(void *, PixelFormat, uint32_t);
 
 	void (*push)(void *, const uint8_t *, uint32_t);
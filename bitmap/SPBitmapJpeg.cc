@@ -163,7 +163,29 @@ struct JpegReadStruct {
 		return true;
 	}
 
+	// pick largest of 1/2, 1/4, 1/8 reductions, that keeps image not smaller then hint
+	void setScale(uint32_t targetWidth, uint32_t targetHeight) {
+		if (targetWidth == 0 && targetHeight == 0) {
+			return;
+		}
+
+		uint32_t denom = 1;
+		while (denom < 8) {
+			auto next = denom * 2;
+			if ((cinfo.image_width + next - 1) / next < targetWidth
+					|| (cinfo.image_height + next - 1) / next < targetHeight) {
+				break;
+			}
+			denom = next;
+		}
+
+		cinfo.scale_num = 1;
+		cinfo.scale_denom = denom;
+	}
+
 	bool load(BitmapWriter &outputData) {
+		setScale(outputData.targetWidth, outputData.targetHeight);
+
 		if (!info(outputData)) {
 			return false;
 		}
@@ -330,6 +352,219 @@ struct JpegWriteStruct {
 	}
 };
 
+// Row-streaming decoder, decompressor is kept between calls
+struct JpegStreamReader {
+	bool init(const uint8_t *inputData, size_t size, ImageInfo &info, uint32_t targetWidth,
+			uint32_t targetHeight) {
+		if (!reader.init(inputData, size)) {
+			return false;
+		}
+
+		reader.setScale(targetWidth, targetHeight);
+
+		if (!reader.info(info)) {
+			return false;
+		}
+
+		if (setjmp(reader.jerr.setjmp_buffer)) {
+			return false;
+		}
+
+		jpeg_start_decompress(&reader.cinfo);
+
+		if (reader.cinfo.out_color_space == JCS_CMYK || reader.cinfo.out_color_space == JCS_YCCK) {
+			buffer.resize(reader.cinfo.output_width * reader.cinfo.output_components);
+		}
+
+		info.width = reader.cinfo.output_width;
+		info.height = reader.cinfo.output_height;
+		info.stride = info.width * getBytesPerPixel(info.color);
+		return true;
+	}
+
+	bool read(uint8_t *row) {
+		if (setjmp(reader.jerr.setjmp_buffer)) {
+			return false;
+		}
+
+		if (reader.cinfo.output_scanline >= reader.cinfo.output_height) {
+			return false;
+		}
+
+		JSAMPROW row_pointer[1] = {0};
+		if (!buffer.empty()) {
+			row_pointer[0] = buffer.data();
+			jpeg_read_scanlines(&reader.cinfo, row_pointer, 1);
+
+			for (size_t i = 0; i < reader.cinfo.output_width; ++i) {
+				*row++ = (buffer[i * 4]) * (buffer[i * 4 + 3]) / 255;
+				*row++ = (buffer[i * 4 + 1]) * (buffer[i * 4 + 3]) / 255;
+				*row++ = (buffer[i * 4 + 2]) * (buffer[i * 4 + 3]) / 255;
+			}
+		} else {
+			row_pointer[0] = row;
+			jpeg_read_scanlines(&reader.cinfo, row_pointer, 1);
+		}
+		return true;
+	}
+
+	JpegReadStruct reader;
+	memory::StandartInterface::BytesType buffer;
+};
+
+// Row-streaming encoder, compressed data is passed to BitmapWriter::push
+// with fixed-size buffer, or written into file
+struct JpegStreamWriter {
+	static constexpr size_t BufferSize = 16_KiB;
+
+	struct Destination {
+		struct jpeg_destination_mgr pub;
+		BitmapWriter *out = nullptr;
+		uint8_t buffer[BufferSize];
+
+		static void init(j_compress_ptr cinfo) {
+			auto dest = (Destination *)cinfo->dest;
+			dest->pub.next_output_byte = dest->buffer;
+			dest->pub.free_in_buffer = BufferSize;
+		}
+
+		static boolean empty(j_compress_ptr cinfo) {
+			auto dest = (Destination *)cinfo->dest;
+			dest->out->push(dest->out->target, dest->buffer, uint32_t(BufferSize));
+			dest->pub.next_output_byte = dest->buffer;
+			dest->pub.free_in_buffer = BufferSize;
+			return boolean(TRUE);
+		}
+
+		static void term(j_compress_ptr cinfo) {
+			auto dest = (Destination *)cinfo->dest;
+			auto size = BufferSize - dest->pub.free_in_buffer;
+			if (size > 0) {
+				dest->out->push(dest->out->target, dest->buffer, uint32_t(size));
+			}
+		}
+	};
+
+	~JpegStreamWriter() {
+		if (initialized) {
+			jpeg_destroy_compress(&cinfo);
+		}
+		if (fp) {
+			fclose(fp);
+		}
+	}
+
+	JpegStreamWriter() {
+		cinfo.err = jpeg_std_error(&jerr.pub);
+		jerr.pub.error_exit = &JpegError::ErrorExit;
+	}
+
+	bool init(BitmapWriter *out) {
+		if (setjmp(jerr.setjmp_buffer)) {
+			return false;
+		}
+
+		jpeg_create_compress(&cinfo);
+		initialized = true;
+
+		dest.out = out;
+		dest.pub.init_destination = &Destination::init;
+		dest.pub.empty_output_buffer = &Destination::empty;
+		dest.pub.term_destination = &Destination::term;
+		cinfo.dest = &dest.pub;
+		return true;
+	}
+
+	bool init(const FileInfo &filename) {
+		filesystem::enumerateWritablePaths(filename, filesystem::Access::None,
+				[&](StringView str, FileFlags) {
+			fp = filesystem::native::fopen_fn(str, "wb");
+			if (fp) {
+				return false;
+			}
+			return true;
+		});
+
+		if (!fp) {
+			log::source().error("Bitmap", "fail to open file ", filename, " to write jpeg data");
+			return false;
+		}
+
+		if (setjmp(jerr.setjmp_buffer)) {
+			return false;
+		}
+
+		jpeg_create_compress(&cinfo);
+		initialized = true;
+
+		jpeg_stdio_dest(&cinfo, fp);
+		return true;
+	}
+
+	bool begin(const ImageInfo &info) {
+		if (setjmp(jerr.setjmp_buffer)) {
+			return false;
+		}
+
+		cinfo.image_width = info.width;
+		cinfo.image_height = info.height;
+
+		switch (info.color) {
+		case PixelFormat::A8:
+		case PixelFormat::I8:
+			cinfo.input_components = 1;
+			cinfo.in_color_space = JCS_GRAYSCALE;
+			break;
+		case PixelFormat::RGB888:
+			cinfo.input_components = 3;
+			cinfo.in_color_space = JCS_RGB;
+			break;
+		default:
+			log::source().error("JPEG", "Color format is not supported by JPEG!");
+			return false;
+			break;
+		}
+
+		jpeg_set_defaults(&cinfo);
+		jpeg_set_quality(&cinfo, 90, boolean(TRUE));
+		jpeg_start_compress(&cinfo, boolean(TRUE));
+		return true;
+	}
+
+	bool write(const uint8_t *row) {
+		if (setjmp(jerr.setjmp_buffer)) {
+			return false;
+		}
+
+		if (cinfo.next_scanline >= cinfo.image_height) {
+			return false;
+		}
+
+		JSAMPROW row_pointer[1] = {const_cast<JSAMPROW>(row)};
+		jpeg_write_scanlines(&cinfo, row_pointer, 1);
+		return true;
+	}
+
+	bool finalize() {
+		if (setjmp(jerr.setjmp_buffer)) {
+			return false;
+		}
+
+		if (cinfo.next_scanline < cinfo.image_height) {
+			return false;
+		}
+
+		jpeg_finish_compress(&cinfo);
+		return true;
+	}
+
+	bool initialized = false;
+	struct jpeg_compress_struct cinfo;
+	struct JpegError jerr;
+	Destination dest;
+	FILE *fp = nullptr;
+};
+
 static bool infoJpg(const uint8_t *inputData, size_t size, ImageInfo &outputData) {
 	JpegReadStruct jpegStruct;
 	return jpegStruct.init(inputData, size) && jpegStruct.info(outputData);
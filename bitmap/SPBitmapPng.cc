@@ -316,6 +316,90 @@ struct PngWriteStruct {
 	}
 };
 
+// Row-streaming decoder, interlaced images can not be decoded row by row
+struct PngStreamReader {
+	bool init(const uint8_t *inputData, size_t size, ImageInfo &info) {
+		if (!reader.init(inputData, size)) {
+			return false;
+		}
+
+		if (png_get_interlace_type(reader.png_ptr, reader.info_ptr) != PNG_INTERLACE_NONE) {
+			return false;
+		}
+
+		return reader.info(info);
+	}
+
+	bool read(uint8_t *row) {
+		if (setjmp(png_jmpbuf(reader.png_ptr))) {
+			log::source().error("libpng", "error in processing (setjmp return)");
+			return false;
+		}
+
+		png_read_row(reader.png_ptr, row, nullptr);
+		return true;
+	}
+
+	PngReadStruct reader;
+};
+
+// Row-streaming encoder, compressed data is passed to BitmapWriter::push or written into file
+struct PngStreamWriter : PngWriteStruct {
+	using PngWriteStruct::PngWriteStruct;
+
+	bool begin(const ImageInfo &info) {
+		if (!valid || (!fp && !out)) {
+			return false;
+		}
+
+		if (setjmp(png_jmpbuf(png_ptr))) {
+			log::source().error("libpng", "error in processing (setjmp return)");
+			return false;
+		}
+
+		int color_type = 0;
+		switch (info.color) {
+		case PixelFormat::A8:
+		case PixelFormat::I8: color_type = PNG_COLOR_TYPE_GRAY; break;
+		case PixelFormat::IA88: color_type = PNG_COLOR_TYPE_GRAY_ALPHA; break;
+		case PixelFormat::RGB888: color_type = PNG_COLOR_TYPE_RGB; break;
+		case PixelFormat::RGBA8888: color_type = PNG_COLOR_TYPE_RGBA; break;
+		default: return false;
+		}
+
+		if (fp) {
+			png_init_io(png_ptr, fp);
+		} else {
+			png_set_write_fn(png_ptr, out, &writePngFn, nullptr);
+		}
+
+		png_set_IHDR(png_ptr, info_ptr, info.width, info.height, bit_depth, color_type,
+				PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT);
+		png_write_info(png_ptr, info_ptr);
+		return true;
+	}
+
+	bool writeRow(const uint8_t *row) {
+		if (setjmp(png_jmpbuf(png_ptr))) {
+			log::source().error("libpng", "error in processing (setjmp return)");
+			return false;
+		}
+
+		png_write_row(png_ptr, row);
+		return true;
+	}
+
+	bool finalize() {
+		if (setjmp(png_jmpbuf(png_ptr))) {
+			log::source().error("libpng", "error in processing (setjmp return)");
+			return false;
+		}
+
+		png_write_end(png_ptr, nullptr);
+		return true;
+	}
+};
+
 SP_UNUSED static bool infoPng(const uint8_t *inputData, size_t size, ImageInfo &outputData) {
 	PngReadStruct pngStruct;
 	return pngStruct.init(inputData, size) && pngStruct.info(outputData);
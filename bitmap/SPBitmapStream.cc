@@ -0,0 +1,350 @@
+/**
+ Copyright (c) 2025 Stappler LLC <admin@stappler.dev>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ **/
+
+#include "SPBitmapStream.h"
+#include "SPLog.h"
+
+namespace STAPPLER_VERSIONIZED stappler::bitmap {
+
+const BitmapFormat &getDefaultFormat(uint32_t);
+
+struct BitmapDecoderPng : BitmapDecoder::Stream {
+	virtual bool read(uint8_t *row) override { return reader.read(row); }
+
+	png::PngStreamReader reader;
+};
+
+struct BitmapDecoderJpeg : BitmapDecoder::Stream {
+	virtual bool read(uint8_t *row) override { return reader.read(row); }
+
+	jpeg::JpegStreamReader reader;
+};
+
+// fallback for formats without incremental decoding
+struct BitmapDecoderBuffer : BitmapDecoder::Stream {
+	virtual bool read(uint8_t *row) override {
+		if (next >= bitmap.height()) {
+			return false;
+		}
+
+		memcpy(row, bitmap.dataPtr() + size_t(next) * bitmap.stride(),
+				bitmap.width() * getBytesPerPixel(bitmap.format()));
+		++next;
+		return true;
+	}
+
+	BitmapTemplate<memory::StandartInterface> bitmap;
+	uint32_t next = 0;
+};
+
+struct BitmapEncoderPng : BitmapEncoder::Stream {
+	template <typename... Args>
+	BitmapEncoderPng(Args &&...args) : writer(std::forward<Args>(args)...) { }
+
+	virtual bool write(const uint8_t *row) override { return writer.writeRow(row); }
+	virtual bool finalize() override { return writer.finalize(); }
+
+	png::PngStreamWriter writer;
+};
+
+struct BitmapEncoderJpeg : BitmapEncoder::Stream {
+	virtual bool write(const uint8_t *row) override { return writer.write(row); }
+	virtual bool finalize() override { return writer.finalize(); }
+
+	jpeg::JpegStreamWriter writer;
+};
+
+// fallback for formats without incremental encoding
+struct BitmapEncoderBuffer : BitmapEncoder::Stream {
+	virtual bool write(const uint8_t *row) override {
+		if (next >= bitmap.height()) {
+			return false;
+		}
+
+		memcpy(bitmap.dataPtr() + size_t(next) * bitmap.stride(), row,
+				bitmap.width() * getBytesPerPixel(bitmap.format()));
+		++next;
+		return true;
+	}
+
+	virtual bool finalize() override {
+		if (out) {
+			auto data = bitmap.write(format);
+			if (data.empty()) {
+				return false;
+			}
+			out->push(out->target, data.data(), uint32_t(data.size()));
+			return true;
+		} else {
+			return bitmap.save(format, FileInfo(path, category, flags));
+		}
+	}
+
+	BitmapTemplate<memory::StandartInterface> bitmap;
+	uint32_t next = 0;
+	FileFormat format = FileFormat::Png;
+	BitmapWriter *out = nullptr;
+	memory::StandartInterface::StringType path;
+	FileCategory category = FileCategory::Custom;
+	FileFlags flags = FileFlags::None;
+};
+
+BitmapDecoder::BitmapDecoder(const uint8_t *data, size_t size, uint32_t targetWidth,
+		uint32_t targetHeight) {
+	if (png::isPng(data, size)) {
+		auto stream = new BitmapDecoderPng;
+		if (stream->reader.init(data, size, _info)) {
+			_stream = stream;
+			_format = FileFormat::Png;
+		} else {
+			delete stream;
+		}
+	} else if (jpeg::isJpg(data, size)) {
+		auto stream = new BitmapDecoderJpeg;
+		if (stream->reader.init(data, size, _info, targetWidth, targetHeight)) {
+			_stream = stream;
+			_format = FileFormat::Jpeg;
+		} else {
+			delete stream;
+		}
+	}
+
+	if (_stream) {
+		_formatName = getDefaultFormat(toInt(_format)).getName();
+		return;
+	}
+
+	auto stream = new BitmapDecoderBuffer;
+	if (stream->bitmap.loadData(data, size)) {
+		_info = ImageInfo();
+		_info.color = stream->bitmap.format();
+		_info.alpha = stream->bitmap.alpha();
+		_info.width = stream->bitmap.width();
+		_info.height = stream->bitmap.height();
+		_info.stride = getRowSize();
+		_format = stream->bitmap.getOriginalFormat();
+		_formatName = stream->bitmap.getOriginalFormatName();
+		_stream = stream;
+	} else {
+		_info = ImageInfo();
+		delete stream;
+	}
+}
+
+BitmapDecoder::BitmapDecoder(BytesView data, uint32_t targetWidth, uint32_t targetHeight)
+: BitmapDecoder(data.data(), data.size(), targetWidth, targetHeight) { }
+
+BitmapDecoder::~BitmapDecoder() {
+	if (_stream) {
+		delete _stream;
+		_stream = nullptr;
+	}
+}
+
+BitmapDecoder::BitmapDecoder(BitmapDecoder &&other)
+: _info(other._info)
+, _format(other._format)
+, _formatName(other._formatName)
+, _row(other._row)
+, _stream(other._stream) {
+	other._stream = nullptr;
+}
+
+BitmapDecoder &BitmapDecoder::operator=(BitmapDecoder &&other) {
+	if (&other == this) {
+		return *this;
+	}
+
+	if (_stream) {
+		delete _stream;
+	}
+
+	_info = other._info;
+	_format = other._format;
+	_formatName = other._formatName;
+	_row = other._row;
+	_stream = other._stream;
+	other._stream = nullptr;
+	return *this;
+}
+
+bool BitmapDecoder::readRow(uint8_t *row) {
+	if (!_stream || _row >= _info.height) {
+		return false;
+	}
+
+	if (_stream->read(row)) {
+		++_row;
+		return true;
+	}
+	return false;
+}
+
+static bool BitmapEncoder_validate(FileFormat fmt, const ImageInfo &info) {
+	if (info.width == 0 || info.height == 0 || getBytesPerPixel(info.color) == 0) {
+		log::format(log::Error, "Bitmap", SP_LOCATION, "Invalid image info for encoder (%u x %u)",
+				info.width, info.height);
+		return false;
+	}
+
+	if (fmt == FileFormat::Custom) {
+		log::error("Bitmap", "Custom formats are not supported by BitmapEncoder");
+		return false;
+	}
+
+	return true;
+}
+
+static BitmapEncoderBuffer *BitmapEncoder_makeBuffer(FileFormat fmt, const ImageInfo &info) {
+	auto stream = new BitmapEncoderBuffer;
+	stream->format = fmt;
+	stream->bitmap.alloc(info.width, info.height, info.color, info.alpha);
+	return stream;
+}
+
+BitmapEncoder::BitmapEncoder(FileFormat fmt, const ImageInfo &info, BitmapWriter &out)
+: _info(info), _format(fmt) {
+	_info.stride = getRowSize();
+
+	if (!BitmapEncoder_validate(fmt, _info)) {
+		return;
+	}
+
+	switch (fmt) {
+	case FileFormat::Png: {
+		auto stream = new BitmapEncoderPng(&out);
+		if (stream->writer.begin(_info)) {
+			_stream = stream;
+		} else {
+			delete stream;
+		}
+		break;
+	}
+	case FileFormat::Jpeg: {
+		auto stream = new BitmapEncoderJpeg;
+		if (stream->writer.init(&out) && stream->writer.begin(_info)) {
+			_stream = stream;
+		} else {
+			delete stream;
+		}
+		break;
+	}
+	default: {
+		auto stream = BitmapEncoder_makeBuffer(fmt, _info);
+		stream->out = &out;
+		_stream = stream;
+		break;
+	}
+	}
+}
+
+BitmapEncoder::BitmapEncoder(FileFormat fmt, const ImageInfo &info, const FileInfo &path)
+: _info(info), _format(fmt) {
+	_info.stride = getRowSize();
+
+	if (!BitmapEncoder_validate(fmt, _info)) {
+		return;
+	}
+
+	switch (fmt) {
+	case FileFormat::Png: {
+		auto stream = new BitmapEncoderPng(path);
+		if (stream->writer.begin(_info)) {
+			_stream = stream;
+		} else {
+			delete stream;
+		}
+		break;
+	}
+	case FileFormat::Jpeg: {
+		auto stream = new BitmapEncoderJpeg;
+		if (stream->writer.init(path) && stream->writer.begin(_info)) {
+			_stream = stream;
+		} else {
+			delete stream;
+		}
+		break;
+	}
+	default: {
+		auto stream = BitmapEncoder_makeBuffer(fmt, _info);
+		stream->path = path.path.str<memory::StandartInterface>();
+		stream->category = path.category;
+		stream->flags = path.flags;
+		_stream = stream;
+		break;
+	}
+	}
+}
+
+BitmapEncoder::~BitmapEncoder() {
+	if (_stream) {
+		delete _stream;
+		_stream = nullptr;
+	}
+}
+
+BitmapEncoder::BitmapEncoder(BitmapEncoder &&other)
+: _info(other._info), _format(other._format), _row(other._row), _stream(other._stream) {
+	other._stream = nullptr;
+}
+
+BitmapEncoder &BitmapEncoder::operator=(BitmapEncoder &&other) {
+	if (&other == this) {
+		return *this;
+	}
+
+	if (_stream) {
+		delete _stream;
+	}
+
+	_info = other._info;
+	_format = other._format;
+	_row = other._row;
+	_stream = other._stream;
+	other._stream = nullptr;
+	return *this;
+}
+
+bool BitmapEncoder::writeRow(const uint8_t *row) {
+	if (!_stream || _row >= _info.height) {
+		return false;
+	}
+
+	if (_stream->write(row)) {
+		++_row;
+		return true;
+	}
+	return false;
+}
+
+bool BitmapEncoder::finalize() {
+	if (!_stream || _row != _info.height) {
+		return false;
+	}
+
+	auto ret = _stream->finalize();
+	delete _stream;
+	_stream = nullptr;
+	return ret;
+}
+
+} // namespace stappler::bitmap
@@ -0,0 +1,135 @@
+/**
+ Copyright (c) 2025 Stappler LLC <admin@stappler.dev>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ **/
+
+#ifndef STAPPLER_BITMAP_SPBITMAPSTREAM_H_
+#define STAPPLER_BITMAP_SPBITMAPSTREAM_H_
+
+#include "SPBitmap.h"
+
+namespace STAPPLER_VERSIONIZED stappler::bitmap {
+
+// Pull-based row decoder: rows are decoded top to bottom on request
+//
+// PNG (non-interlaced) and JPEG are decoded incrementally with O(width) memory,
+// other formats are decoded at once into internal buffer, then served row by row.
+// Encoded data should outlive decoder.
+class SP_PUBLIC BitmapDecoder final {
+public:
+	struct Stream {
+		virtual ~Stream() = default;
+		virtual bool read(uint8_t *) = 0;
+	};
+
+	BitmapDecoder() = default;
+
+	// size hint works like one for BitmapTemplate::loadData: JPEG can be decoded with reduced size,
+	// but not smaller then target; use resample to get exact size
+	BitmapDecoder(const uint8_t *, size_t, uint32_t targetWidth = 0, uint32_t targetHeight = 0);
+	BitmapDecoder(BytesView, uint32_t targetWidth = 0, uint32_t targetHeight = 0);
+
+	~BitmapDecoder();
+
+	BitmapDecoder(const BitmapDecoder &) = delete;
+	BitmapDecoder &operator=(const BitmapDecoder &) = delete;
+
+	BitmapDecoder(BitmapDecoder &&);
+	BitmapDecoder &operator=(BitmapDecoder &&);
+
+	explicit operator bool() const { return _stream != nullptr; }
+
+	const ImageInfo &getInfo() const { return _info; }
+	FileFormat getFormat() const { return _format; }
+	StringView getFormatName() const { return _formatName; }
+
+	// size of decoded row in bytes, buffer for readRow should be at least this size
+	uint32_t getRowSize() const { return _info.width * getBytesPerPixel(_info.color); }
+
+	// number of rows, that was already read
+	uint32_t getRow() const { return _row; }
+
+	// returns false after last row or on decoding error
+	bool readRow(uint8_t *);
+
+protected:
+	ImageInfo _info;
+	FileFormat _format = FileFormat::Custom;
+	StringView _formatName;
+	uint32_t _row = 0;
+	Stream *_stream = nullptr;
+};
+
+// Push-based row encoder: rows in format from info are encoded as they arrive
+//
+// PNG and JPEG are encoded incrementally, encoded data is passed to BitmapWriter::push
+// (only `target` and `push` fields are used) or written into file.
+// Other formats collect rows into internal buffer and are encoded on finalize.
+class SP_PUBLIC BitmapEncoder final {
+public:
+	struct Stream {
+		virtual ~Stream() = default;
+		virtual bool write(const uint8_t *) = 0;
+		virtual bool finalize() = 0;
+	};
+
+	BitmapEncoder() = default;
+
+	BitmapEncoder(FileFormat, const ImageInfo &, BitmapWriter &out);
+	BitmapEncoder(FileFormat, const ImageInfo &, const FileInfo &);
+
+	~BitmapEncoder();
+
+	BitmapEncoder(const BitmapEncoder &) = delete;
+	BitmapEncoder &operator=(const BitmapEncoder &) = delete;
+
+	BitmapEncoder(BitmapEncoder &&);
+	BitmapEncoder &operator=(BitmapEncoder &&);
+
+	explicit operator bool() const { return _stream != nullptr; }
+
+	const ImageInfo &getInfo() const { return _info; }
+	FileFormat getFormat() const { return _format; }
+
+	uint32_t getRowSize() const { return _info.width * getBytesPerPixel(_info.color); }
+	uint32_t getRow() const { return _row; }
+
+	bool writeRow(const uint8_t *);
+
+	// should be called after last row, fails if not all rows was written
+	bool finalize();
+
+protected:
+	ImageInfo _info;
+	FileFormat _format = FileFormat::Custom;
+	uint32_t _row = 0;
+	Stream *_stream = nullptr;
+};
+
+// Streams rows from decoder into encoder, resizing image to encoder's dimensions
+// and converting pixel and alpha format to encoder's one.
+// Only filter window of horizontally resampled rows is kept in memory.
+// Encoder is finalized on success.
+SP_PUBLIC bool resample(BitmapDecoder &, BitmapEncoder &,
+		ResampleFilter = ResampleFilter::Default);
+
+} // namespace stappler::bitmap
+
+#endif /* STAPPLER_BITMAP_SPBITMAPSTREAM_H_ */
@@ -129,6 +129,25 @@ static bool loadWebp(const uint8_t *inputData, size_t size, BitmapWriter &output
 		return false;
 	}
 
+	if (outputData.targetWidth > 0 || outputData.targetHeight > 0) {
+		// scale down with built-in scaler, preserving aspect ratio,
+		// result should be not smaller then hint in any dimension
+		auto scale = max(float(outputData.targetWidth) / float(outputData.width),
+				float(outputData.targetHeight) / float(outputData.height));
+		if (scale < 1.0f) {
+			auto w = max(uint32_t(std::ceil(outputData.width * scale)), outputData.targetWidth);
+			auto h = max(uint32_t(std::ceil(outputData.height * scale)), outputData.targetHeight);
+			if (w < outputData.width && h < outputData.height) {
+				config.options.use_scaling = 1;
+				config.options.scaled_width = int(w);
+				config.options.scaled_height = int(h);
+				outputData.width = w;
+				outputData.height = h;
+				outputData.stride = w * getBytesPerPixel(outputData.color);
+			}
+		}
+	}
+
 	if (outputData.getStride) {
 		outputData.stride = max((uint32_t)outputData.getStride(outputData.target, outputData.color,
 										outputData.width),
@@ -230,6 +230,40 @@ struct Pkcs1RsaPubKeyReader {
 	BytesViewNetwork mod;
 };
 
+// Acquires cipher handle, ready to process new block with zero IV
+static gnutls_cipher_hd_t GnuTLS_prepareBlockContext(BlockContext &ctx) {
+	uint8_t iv[16] = {0};
+
+	auto aes = static_cast<gnutls_cipher_hd_t>(ctx.encCtx);
+	if (aes) {
+		if (ctx.key.cipher != BlockCipher::Gost3412_2015_CTR_ACPKM) {
+			// keep expanded key, reset only IV
+			gnutls_cipher_set_iv(aes, iv, 16);
+			return aes;
+		}
+
+		// ACPKM modifies key during encryption, so it always requires full initialization
+		gnutls_cipher_deinit(aes);
+		ctx.encCtx = nullptr;
+	}
+
+	gnutls_datum_t ivData = {.data = static_cast<unsigned char *>(iv),
+		.size = static_cast<unsigned int>(16)};
+
+	gnutls_datum_t keyData = {.data = const_cast<unsigned char *>(
+									  static_cast<const unsigned char *>(ctx.key.data.data())),
+		.size = static_cast<unsigned int>(ctx.key.data.size())};
+
+	auto err = gnutls_cipher_init(&aes, getGnuTLSAlgo(ctx.key.cipher), &keyData, &ivData);
+	if (err != 0) {
+		log::source().error("Crypto", "gnutls_cipher_init() = [", err, "] ", gnutls_strerror(err));
+		return nullptr;
+	}
+
+	ctx.encCtx = aes;
+	return aes;
+}
+
 static BackendCtx s_gnuTLSCtx = {
 	.name = Backend::GnuTLS,
 	.title = StringView("GnuTLS"),
@@ -247,10 +281,28 @@ static BackendCtx s_gnuTLSCtx = {
 	gnutls_global_init();
 },
 	.finalize = [](BackendCtx &) { gnutls_global_deinit(); },
-	.encryptBlock = [](const BlockKey256 &key, BytesView d,
+	.blockInit = [](BlockContext &ctx, const BlockKey256 &key) -> bool {
+	// GnuTLS can not re-key existing handle, new one will be created on demand;
+	// single handle serves both directions
+	if (ctx.encCtx) {
+		gnutls_cipher_deinit(static_cast<gnutls_cipher_hd_t>(ctx.encCtx));
+		ctx.encCtx = nullptr;
+	}
+
+	ctx.key = key;
+	return true;
+},
+	.blockFree =
+			[](BlockContext &ctx) {
+	if (ctx.encCtx) {
+		gnutls_cipher_deinit(static_cast<gnutls_cipher_hd_t>(ctx.encCtx));
+		ctx.encCtx = nullptr;
+	}
+},
+	.blockEncrypt = [](BlockContext &ctx, BytesView d,
 							const Callback<void(BytesView)> &cb) -> bool {
+	auto &key = ctx.key;
 	auto cipherBlockSize = getBlockSize(key.cipher);
-	auto algo = getGnuTLSAlgo(key.cipher);
 
 	uint64_t dataSize = d.size();
 	auto blockSize = math::align<size_t>(dataSize, cipherBlockSize)
@@ -258,24 +310,15 @@ static BackendCtx s_gnuTLSCtx = {
 
 	uint8_t output[blockSize + sizeof(BlockCryptoHeader)];
 
-	uint8_t iv[16] = {0};
-	gnutls_datum_t ivData = {.data = static_cast<unsigned char *>(iv),
-		.size = static_cast<unsigned int>(16)};
-
-	gnutls_datum_t keyData = {
-		.data = const_cast<unsigned char *>(static_cast<const unsigned char *>(key.data.data())),
-		.size = static_cast<unsigned int>(key.data.size())};
-
-	gnutls_cipher_hd_t aes;
-	auto err = gnutls_cipher_init(&aes, algo, &keyData, &ivData);
-	if (err != 0) {
-		log::source().error("Crypto", "gnutls_cipher_init() = [", err, "] ", gnutls_strerror(err));
+	auto aes = GnuTLS_prepareBlockContext(ctx);
+	if (!aes) {
 		return false;
 	}
 
 	size_t outSize = blockSize - sizeof(BlockCryptoHeader);
 	fillCryptoBlockHeader(output, key, d);
 
+	int err = 0;
 	if constexpr (SAFE_BLOCK_ENCODING) {
 		memcpy(output + sizeof(BlockCryptoHeader), d.data(), d.size());
 		memset(output + sizeof(BlockCryptoHeader) + d.size(), 0, blockSize - d.size());
@@ -286,51 +329,36 @@ static BackendCtx s_gnuTLSCtx = {
 	}
 
 	if (err != 0) {
-		gnutls_cipher_deinit(aes);
 		log::source().error("Crypto", "gnutls_cipher_encrypt() = [", err, "] ",
 				gnutls_strerror(err));
 		return false;
 	}
 
-	gnutls_cipher_deinit(aes);
 	cb(BytesView(output, blockSize + sizeof(BlockCryptoHeader) - cipherBlockSize));
 	return true;
 },
-	.decryptBlock = [](const BlockKey256 &key, BytesView b,
+	.blockDecrypt = [](BlockContext &ctx, BytesView b,
 							const Callback<void(BytesView)> &cb) -> bool {
 	auto info = getBlockInfo(b);
 	auto cipherBlockSize = getBlockSize(info.cipher);
-	auto algo = getGnuTLSAlgo(info.cipher);
 
 	auto blockSize = math::align<size_t>(info.dataSize, cipherBlockSize) + cipherBlockSize;
 	b.offset(sizeof(BlockCryptoHeader));
 
 	uint8_t output[blockSize];
 
-	uint8_t iv[16] = {0};
-	gnutls_datum_t ivData = {.data = static_cast<unsigned char *>(iv),
-		.size = static_cast<unsigned int>(16)};
-
-	gnutls_datum_t keyData = {
-		.data = const_cast<unsigned char *>(static_cast<const unsigned char *>(key.data.data())),
-		.size = static_cast<unsigned int>(key.data.size())};
-
-	gnutls_cipher_hd_t aes;
-	auto err = gnutls_cipher_init(&aes, algo, &keyData, &ivData);
-	if (err != 0) {
-		log::source().error("Crypto", "gnutls_cipher_init() = [", err, "] ", gnutls_strerror(err));
+	auto aes = GnuTLS_prepareBlockContext(ctx);
+	if (!aes) {
 		return false;
 	}
 
-	err = gnutls_cipher_decrypt2(aes, b.data(), b.size(), output, blockSize);
+	auto err = gnutls_cipher_decrypt2(aes, b.data(), b.size(), output, blockSize);
 	if (err != 0) {
-		gnutls_cipher_deinit(aes);
 		log::source().error("Crypto", "gnutls_cipher_decrypt2() = [", err, "] ",
 				gnutls_strerror(err));
 		return false;
 	}
 
-	gnutls_cipher_deinit(aes);
 	cb(BytesView(output, info.dataSize));
 	return true;
 },
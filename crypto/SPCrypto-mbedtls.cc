@@ -82,6 +82,29 @@ struct EntropyContext {
 	explicit operator bool() const { return valid; }
 };
 
+// Acquires AES context with expanded key; IV is passed per call, so context can be reused as is
+static mbedtls_aes_context *MbedTLS_prepareBlockContext(void *&ptr, const BlockKey256 &key, int mode) {
+	if (ptr) {
+		return static_cast<mbedtls_aes_context *>(ptr);
+	}
+
+	auto aes = new mbedtls_aes_context;
+	mbedtls_aes_init(aes);
+
+	// CFB8 uses encryption key schedule for both directions
+	auto err = (mode == MBEDTLS_AES_ENCRYPT || key.cipher == BlockCipher::AES_CFB8)
+			? mbedtls_aes_setkey_enc(aes, key.data.data(), 256)
+			: mbedtls_aes_setkey_dec(aes, key.data.data(), 256);
+	if (err != 0) {
+		mbedtls_aes_free(aes);
+		delete aes;
+		return nullptr;
+	}
+
+	ptr = aes;
+	return aes;
+}
+
 static BackendCtx s_mbedTLSCtx = {
 	.name = Backend::MbedTLS,
 	.title = StringView("MbedTLS"),
@@ -90,7 +113,36 @@ static BackendCtx s_mbedTLSCtx = {
 		log::source().verbose("Crypto", "MbedTLS backend loaded");
 	},
 	.finalize = [] (BackendCtx &) { },
-	.encryptBlock = [] (const BlockKey256 &key, BytesView d, const Callback<void(BytesView)> &cb) -> bool {
+	.blockInit = [] (BlockContext &ctx, const BlockKey256 &key) -> bool {
+		// re-key already allocated contexts, new ones will be created on demand
+		if (ctx.encCtx && mbedtls_aes_setkey_enc(static_cast<mbedtls_aes_context *>(ctx.encCtx), key.data.data(), 256) != 0) {
+			return false;
+		}
+		if (auto aes = static_cast<mbedtls_aes_context *>(ctx.decCtx)) {
+			auto err = (key.cipher == BlockCipher::AES_CFB8)
+					? mbedtls_aes_setkey_enc(aes, key.data.data(), 256)
+					: mbedtls_aes_setkey_dec(aes, key.data.data(), 256);
+			if (err != 0) {
+				return false;
+			}
+		}
+		ctx.key = key;
+		return true;
+	},
+	.blockFree = [] (BlockContext &ctx) {
+		if (auto aes = static_cast<mbedtls_aes_context *>(ctx.encCtx)) {
+			mbedtls_aes_free(aes);
+			delete aes;
+			ctx.encCtx = nullptr;
+		}
+		if (auto aes = static_cast<mbedtls_aes_context *>(ctx.decCtx)) {
+			mbedtls_aes_free(aes);
+			delete aes;
+			ctx.decCtx = nullptr;
+		}
+	},
+	.blockEncrypt = [] (BlockContext &ctx, BytesView d, const Callback<void(BytesView)> &cb) -> bool {
+		auto &key = ctx.key;
 		auto cipherBlockSize = getBlockSize(key.cipher);
 
 		uint64_t dataSize = d.size();
@@ -101,30 +153,24 @@ static BackendCtx s_mbedTLSCtx = {
 
 		fillCryptoBlockHeader(output, key, d);
 
-		auto perform = [&key] (const uint8_t *source, size_t size, uint8_t *out) {
-			bool success = false;
-			mbedtls_aes_context aes;
-			unsigned char iv[16] = { 0 };
+		auto aes = MbedTLS_prepareBlockContext(ctx.encCtx, key, MBEDTLS_AES_ENCRYPT);
+		if (!aes) {
+			return false;
+		}
 
-			mbedtls_aes_init( &aes );
-			if (mbedtls_aes_setkey_enc( &aes, key.data.data(), 256 ) == 0) {
-				switch (key.cipher) {
-				case BlockCipher::AES_CBC:
-					if (mbedtls_aes_crypt_cbc( &aes, MBEDTLS_AES_ENCRYPT, size, iv, source, out ) == 0) {
-						success = true;
-					}
-					break;
-				case BlockCipher::AES_CFB8:
-					if (mbedtls_aes_crypt_cfb8( &aes, MBEDTLS_AES_ENCRYPT, size, iv, source, out ) == 0) {
-						success = true;
-					}
-					break;
-				default:
-					break;
-				}
+		auto perform = [&key, aes] (const uint8_t *source, size_t size, uint8_t *out) {
+			unsigned char iv[16] = { 0 };
+			switch (key.cipher) {
+			case BlockCipher::AES_CBC:
+				return mbedtls_aes_crypt_cbc( aes, MBEDTLS_AES_ENCRYPT, size, iv, source, out ) == 0;
+				break;
+			case BlockCipher::AES_CFB8:
+				return mbedtls_aes_crypt_cfb8( aes, MBEDTLS_AES_ENCRYPT, size, iv, source, out ) == 0;
+				break;
+			default:
+				break;
 			}
-			mbedtls_aes_free( &aes );
-			return success;
+			return false;
 		};
 
 		if constexpr (SAFE_BLOCK_ENCODING) {
@@ -144,7 +190,7 @@ static BackendCtx s_mbedTLSCtx = {
 		cb(BytesView(output, blockSize + sizeof(BlockCryptoHeader) - cipherBlockSize));
 		return true;
 	},
-	.decryptBlock = [] (const BlockKey256 &key, BytesView b, const Callback<void(BytesView)> &cb) -> bool {
+	.blockDecrypt = [] (BlockContext &ctx, BytesView b, const Callback<void(BytesView)> &cb) -> bool {
 		bool success = false;
 		auto info = getBlockInfo(b);
 		auto cipherBlockSize = getBlockSize(info.cipher);
@@ -154,27 +200,28 @@ static BackendCtx s_mbedTLSCtx = {
 
 		uint8_t output[blockSize];
 
-		mbedtls_aes_context aes;
+		auto aes = MbedTLS_prepareBlockContext(ctx.decCtx, ctx.key, MBEDTLS_AES_DECRYPT);
+		if (!aes) {
+			return false;
+		}
+
 		unsigned char iv[16] = { 0 };
 
-		mbedtls_aes_init( &aes );
-		if (mbedtls_aes_setkey_dec( &aes, key.data.data(), 256 ) == 0) {
-			switch (info.cipher) {
-			case BlockCipher::AES_CBC:
-				if (mbedtls_aes_crypt_cbc( &aes, MBEDTLS_AES_DECRYPT, blockSize, iv, b.data(), output ) == 0) {
-					success = true;
-				}
-				break;
-			case BlockCipher::AES_CFB8:
-				if (mbedtls_aes_crypt_cfb8( &aes, MBEDTLS_AES_DECRYPT, blockSize, iv, b.data(), output ) == 0) {
-					success = true;
-				}
-				break;
-			default:
-				break;
+		switch (info.cipher) {
+		case BlockCipher::AES_CBC:
+			if (mbedtls_aes_crypt_cbc( aes, MBEDTLS_AES_DECRYPT, blockSize, iv, b.data(), output ) == 0) {
+				success = true;
 			}
+			break;
+		case BlockCipher::AES_CFB8:
+			if (mbedtls_aes_crypt_cfb8( aes, MBEDTLS_AES_DECRYPT, blockSize, iv, b.data(), output ) == 0) {
+				success = true;
+			}
+			break;
+		default:
+			break;
 		}
-		mbedtls_aes_free( &aes );
+
 		if (success) {
 			cb(BytesView(output, info.dataSize));
 		}
@@ -489,6 +489,33 @@ static const EVP_CIPHER *getOpenSSLCipher(BlockCipher b) {
 	return EVP_aes_256_cbc();
 }
 
+// Acquires cipher context, ready to process new block with zero IV
+static EVP_CIPHER_CTX *OpenSSL_prepareBlockContext(void *&ptr, const BlockKey256 &key, int enc) {
+	uint8_t iv[16] = { 0 };
+	auto c = static_cast<EVP_CIPHER_CTX *>(ptr);
+	if (c && key.cipher != BlockCipher::Gost3412_2015_CTR_ACPKM) {
+		// keep expanded key, reset only IV and internal buffers
+		if (!EVP_CipherInit_ex(c, NULL, NULL, NULL, iv, enc)) {
+			return nullptr;
+		}
+		return c;
+	}
+
+	// ACPKM modifies key during encryption, so it always requires full initialization
+	if (!c) {
+		c = EVP_CIPHER_CTX_new();
+		if (!c) {
+			return nullptr;
+		}
+		ptr = c;
+	}
+
+	if (!EVP_CipherInit_ex(c, getOpenSSLCipher(key.cipher), NULL, key.data.data(), iv, enc)) {
+		return nullptr;
+	}
+	return c;
+}
+
 static bool s_opensslHasGost = false;
 
 static bool OpenSSL_initSPGost() {
@@ -578,9 +605,34 @@ static BackendCtx s_openSSLCtx = {
 			SP_ERR_unload_GOST_strings();
 		}
 	},
-	.encryptBlock = [] (const BlockKey256 &key, BytesView d, const Callback<void(BytesView)> &cb) -> bool {
-		auto cipherBlockSize = getBlockSize(key.cipher);
+	.blockInit = [] (BlockContext &ctx, const BlockKey256 &key) -> bool {
 		auto cipher = getOpenSSLCipher(key.cipher);
+		uint8_t iv[16] = { 0 };
+
+		// re-key already allocated contexts, new ones will be created on demand
+		if (ctx.encCtx && !EVP_EncryptInit_ex(static_cast<EVP_CIPHER_CTX *>(ctx.encCtx), cipher, NULL, key.data.data(), iv)) {
+			return false;
+		}
+		if (ctx.decCtx && !EVP_DecryptInit_ex(static_cast<EVP_CIPHER_CTX *>(ctx.decCtx), cipher, NULL, key.data.data(), iv)) {
+			return false;
+		}
+
+		ctx.key = key;
+		return true;
+	},
+	.blockFree = [] (BlockContext &ctx) {
+		if (ctx.encCtx) {
+			EVP_CIPHER_CTX_free(static_cast<EVP_CIPHER_CTX *>(ctx.encCtx));
+			ctx.encCtx = nullptr;
+		}
+		if (ctx.decCtx) {
+			EVP_CIPHER_CTX_free(static_cast<EVP_CIPHER_CTX *>(ctx.decCtx));
+			ctx.decCtx = nullptr;
+		}
+	},
+	.blockEncrypt = [] (BlockContext &ctx, BytesView d, const Callback<void(BytesView)> &cb) -> bool {
+		auto &key = ctx.key;
+		auto cipherBlockSize = getBlockSize(key.cipher);
 
 		uint64_t dataSize = d.size();
 		auto blockSize = math::align<size_t>(dataSize, cipherBlockSize)
@@ -588,26 +640,9 @@ static BackendCtx s_openSSLCtx = {
 
 		uint8_t output[blockSize + sizeof(BlockCryptoHeader)];
 
-		fillCryptoBlockHeader(output, key, d);
-
-		uint8_t iv[16] = { 0 };
-		EVP_CIPHER_CTX *en = nullptr;
-
-		auto finalize = [&] (bool value) {
-			if (en) {
-				EVP_CIPHER_CTX_free(en);
-				en = nullptr;
-			}
-			return value;
-		};
-
-		en = EVP_CIPHER_CTX_new();
+		auto en = OpenSSL_prepareBlockContext(ctx.encCtx, key, 1);
 		if (!en) {
-			return finalize(false);
-		}
-
-		if (!EVP_EncryptInit_ex(en, cipher, NULL, key.data.data(), iv)) {
-			return finalize(false);
+			return false;
 		}
 
 		auto perform = [] (EVP_CIPHER_CTX *en, const uint8_t *target, size_t targetSize, uint8_t *out) {
@@ -641,45 +676,29 @@ static BackendCtx s_openSSLCtx = {
 			memcpy(tmp, d.data(), d.size());
 
 			if (!perform(en, tmp, blockSize - cipherBlockSize, output + sizeof(BlockCryptoHeader))) {
-				return finalize(false);
+				return false;
 			}
 		} else {
 			if (!perform(en, d.data(), d.size(), output + sizeof(BlockCryptoHeader))) {
-				return finalize(false);
+				return false;
 			}
 		}
 
 		cb(BytesView(output, blockSize + sizeof(BlockCryptoHeader) - cipherBlockSize));
-		return finalize(true);
+		return true;
 	},
-	.decryptBlock = [] (const BlockKey256 &key, BytesView b, const Callback<void(BytesView)> &cb) -> bool {
+	.blockDecrypt = [] (BlockContext &ctx, BytesView b, const Callback<void(BytesView)> &cb) -> bool {
 		auto info = getBlockInfo(b);
 		auto cipherBlockSize = getBlockSize(info.cipher);
-		auto cipher = getOpenSSLCipher(info.cipher);
 
 		auto blockSize = math::align<size_t>(info.dataSize, cipherBlockSize) + cipherBlockSize;
 		b.offset(sizeof(BlockCryptoHeader));
 
 		uint8_t output[blockSize];
 
-		uint8_t iv[16] = { 0 };
-		EVP_CIPHER_CTX *de = nullptr;
-
-		auto finalize = [&] (bool value) {
-			if (de) {
-				EVP_CIPHER_CTX_free(de);
-				de = nullptr;
-			}
-			return value;
-		};
-
-		de = EVP_CIPHER_CTX_new();
+		auto de = OpenSSL_prepareBlockContext(ctx.decCtx, ctx.key, 0);
 		if (!de) {
-			return finalize(false);
-		}
-
-		if (!EVP_DecryptInit_ex(de, cipher, NULL, key.data.data(), iv)) {
-			return finalize(false);
+			return false;
 		}
 
 		auto target = b.data();
@@ -689,7 +708,7 @@ static BackendCtx s_openSSLCtx = {
 		int outSize = 0;
 		while (targetSize > 0) {
 			if (!EVP_DecryptUpdate(de, out, &outSize, target, int(targetSize))) {
-				return finalize(false);
+				return false;
 			}
 
 			out += outSize;
@@ -704,7 +723,7 @@ static BackendCtx s_openSSLCtx = {
 		EVP_DecryptFinal(de, out, &outSize); // gives false-positive error
 
 		cb(BytesView(output, info.dataSize));
-		return finalize(true);
+		return true;
 	},
 	.hash256 = [] (Sha256::Buf &buf, const Callback<void( const HashCoderCallback &upd )> &cb, HashFunction func) -> bool {
 		bool success = true;
@@ -226,6 +226,52 @@ protected:
 	KeyContext _key;
 };
 
+// backend-specific state of CipherContext
+struct BlockContext;
+
+// Reusable block cipher context
+//
+// Holds backend cipher objects and expanded key schedule between calls, so repeated
+// encryption/decryption skips backend context allocation, and key expansion when key is unchanged.
+// Context is owned by the caller and is not thread-safe. Key schedule and key copy are destroyed
+// and zeroized on clear() and in destructor, so keep context only as long as key is in use.
+//
+// Ciphertext format is the same as for encryptBlock/decryptBlock
+class SP_PUBLIC CipherContext {
+public:
+	CipherContext(Backend = Backend::Default);
+	CipherContext(Backend, const BlockKey256 &);
+	CipherContext(const BlockKey256 &);
+	~CipherContext();
+
+	CipherContext(const CipherContext &) = delete;
+	CipherContext &operator=(const CipherContext &) = delete;
+
+	CipherContext(CipherContext &&);
+	CipherContext &operator=(CipherContext &&);
+
+	// (Re)initialize context with key; no-op if key is the same as current one
+	bool setKey(const BlockKey256 &);
+
+	bool encrypt(BytesView, const Callback<void(BytesView)> &);
+	bool encrypt(const BlockKey256 &, BytesView, const Callback<void(BytesView)> &);
+
+	bool decrypt(BytesView, const Callback<void(BytesView)> &);
+	bool decrypt(const BlockKey256 &, BytesView, const Callback<void(BytesView)> &);
+
+	// free backend objects and zeroize key material
+	void clear();
+
+	Backend getBackend() const;
+
+	explicit operator bool() const { return _loaded; }
+
+protected:
+	Backend _backend = Backend::Default;
+	bool _loaded = false;
+	BlockContext *_block = nullptr;
+};
+
 inline constexpr size_t getBlockSize(BlockCipher c) {
 	switch (c) {
 	case BlockCipher::AES_CBC:
@@ -247,6 +293,13 @@ SP_PUBLIC bool decryptBlock(const BlockKey256 &, BytesView, const Callback<void(
 SP_PUBLIC bool decryptBlock(Backend b, const BlockKey256 &, BytesView,
 		const Callback<void(BytesView)> &);
 
+// Same as above, but with caller-owned context, so backend objects are allocated once
+// for all calls, and key is re-expanded only when it differs from previous one
+SP_PUBLIC bool encryptBlock(CipherContext &, const BlockKey256 &, BytesView,
+		const Callback<void(BytesView)> &);
+SP_PUBLIC bool decryptBlock(CipherContext &, const BlockKey256 &, BytesView,
+		const Callback<void(BytesView)> &);
+
 SP_PUBLIC BlockKey256 makeBlockKey(Backend, BytesView pkey, BytesView hash,
 		BlockCipher = BlockCipher::AES_CBC, uint32_t version = 2);
 SP_PUBLIC BlockKey256 makeBlockKey(BytesView pkey, BytesView hash,
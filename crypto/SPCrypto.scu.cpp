@@ -29,6 +29,13 @@ THE SOFTWARE.
 
 namespace STAPPLER_VERSIONIZED stappler::crypto {
 
+struct BlockContext {
+	void *encCtx = nullptr;
+	void *decCtx = nullptr;
+	BlockKey256 key;
+	void *backendCtx = nullptr;
+};
+
 struct BackendCtx {
 	static BackendCtx *get(Backend);
 
@@ -39,9 +46,12 @@ struct BackendCtx {
 	void (*initialize)(BackendCtx &) = nullptr;
 	void (*finalize)(BackendCtx &) = nullptr;
 
-	bool (*encryptBlock)(const BlockKey256 &key, BytesView d,
+	// (re)initialize block context with the key, reusing already allocated backend objects
+	bool (*blockInit)(BlockContext &ctx, const BlockKey256 &key) = nullptr;
+	void (*blockFree)(BlockContext &ctx) = nullptr;
+	bool (*blockEncrypt)(BlockContext &ctx, BytesView d,
 			const Callback<void(BytesView)> &cb) = nullptr;
-	bool (*decryptBlock)(const BlockKey256 &key, BytesView d,
+	bool (*blockDecrypt)(BlockContext &ctx, BytesView d,
 			const Callback<void(BytesView)> &cb) = nullptr;
 
 	bool (*hash256)(Sha256::Buf &, const Callback<void(const HashCoderCallback &upd)> &cb,
@@ -172,14 +182,14 @@ static bool isBackendValidForBlock(BackendCtx *b, BlockCipher c) {
 	switch (c) {
 	case BlockCipher::AES_CBC:
 	case BlockCipher::AES_CFB8:
-		if ((b->flags & BackendFlags::SupportsAes) != BackendFlags::None && b->encryptBlock
-				&& b->decryptBlock) {
+		if ((b->flags & BackendFlags::SupportsAes) != BackendFlags::None && b->blockInit
+				&& b->blockEncrypt && b->blockDecrypt) {
 			return true;
 		}
 		break;
 	case BlockCipher::Gost3412_2015_CTR_ACPKM:
 		if ((b->flags & BackendFlags::SupportsGost3412_2015) != BackendFlags::None
-				&& b->encryptBlock && b->decryptBlock) {
+				&& b->blockInit && b->blockEncrypt && b->blockDecrypt) {
 			return true;
 		}
 		break;
@@ -242,32 +252,194 @@ static SignAlgorithm getSignForBlockCipher(const PrivateKey &key) {
 	return SignAlgorithm::RSA_SHA512;
 }
 
-bool encryptBlock(const BlockKey256 &key, BytesView data, const Callback<void(BytesView)> &cb) {
-	auto b = findBackendForBlock(key.cipher);
-	return b->encryptBlock(key, data, cb);
+// compiler should not optimize out writes into memory, that is freed just after
+static void CipherContext_zeroize(void *ptr, size_t size) {
+	auto p = static_cast<volatile uint8_t *>(ptr);
+	while (size--) {
+		*p++ = 0;
+	}
 }
 
-bool encryptBlock(Backend b, const BlockKey256 &key, BytesView data,
+CipherContext::CipherContext(Backend b) : _backend(b) { }
+
+CipherContext::CipherContext(Backend b, const BlockKey256 &key) : CipherContext(b) {
+	setKey(key);
+}
+
+CipherContext::CipherContext(const BlockKey256 &key) : CipherContext(Backend::Default, key) { }
+
+CipherContext::~CipherContext() { clear(); }
+
+CipherContext::CipherContext(CipherContext &&other)
+: _backend(other._backend), _loaded(other._loaded), _block(other._block) {
+	other._loaded = false;
+	other._block = nullptr;
+}
+
+CipherContext &CipherContext::operator=(CipherContext &&other) {
+	if (this != &other) {
+		clear();
+
+		_backend = other._backend;
+		_loaded = other._loaded;
+		_block = other._block;
+
+		other._loaded = false;
+		other._block = nullptr;
+	}
+	return *this;
+}
+
+bool CipherContext::setKey(const BlockKey256 &key) {
+	BackendCtx *backend = nullptr;
+	if (_backend == Backend::Default) {
+		backend = findBackendForBlock(key.cipher);
+	} else {
+		backend = BackendCtx::get(_backend);
+	}
+
+	if (!backend || !backend->blockInit) {
+		clear();
+		return false;
+	}
+
+	if (_loaded && _block->backendCtx == backend && _block->key == key) {
+		return true;
+	}
+
+	if (_block && _block->backendCtx != backend) {
+		clear();
+	}
+
+	if (!_block) {
+		_block = new BlockContext;
+	} else {
+		// backend objects are re-keyed in place, previous key should not stay in memory
+		CipherContext_zeroize(_block->key.data.data(), _block->key.data.size());
+	}
+
+	_block->backendCtx = backend;
+	_loaded = backend->blockInit(*_block, key);
+	if (!_loaded) {
+		clear();
+	}
+	return _loaded;
+}
+
+bool CipherContext::encrypt(BytesView data, const Callback<void(BytesView)> &cb) {
+	if (!_loaded) {
+		return false;
+	}
+
+	auto backend = static_cast<BackendCtx *>(_block->backendCtx);
+	if (backend && backend->blockEncrypt) {
+		return backend->blockEncrypt(*_block, data, cb);
+	}
+	return false;
+}
+
+bool CipherContext::encrypt(const BlockKey256 &key, BytesView data,
 		const Callback<void(BytesView)> &cb) {
-	auto backend = BackendCtx::get(b);
-	if (!backend || !backend->encryptBlock) {
+	if (!setKey(key)) {
 		return false;
 	}
-	return backend->encryptBlock(key, data, cb);
+	return encrypt(data, cb);
 }
 
-bool decryptBlock(const BlockKey256 &key, BytesView data, const Callback<void(BytesView)> &cb) {
-	auto b = findBackendForBlock(key.cipher);
-	return b->decryptBlock(key, data, cb);
+bool CipherContext::decrypt(BytesView data, const Callback<void(BytesView)> &cb) {
+	if (!_loaded || data.size() < sizeof(BlockCryptoHeader)) {
+		return false;
+	}
+
+	// cipher is defined by block header, not by the key
+	auto info = getBlockInfo(data);
+	if (info.cipher != _block->key.cipher) {
+		auto key = _block->key;
+		key.cipher = info.cipher;
+		auto success = setKey(key);
+		CipherContext_zeroize(key.data.data(), key.data.size());
+		if (!success) {
+			return false;
+		}
+	}
+
+	auto backend = static_cast<BackendCtx *>(_block->backendCtx);
+	if (backend && backend->blockDecrypt) {
+		return backend->blockDecrypt(*_block, data, cb);
+	}
+	return false;
 }
 
-bool decryptBlock(Backend b, const BlockKey256 &key, BytesView data,
+bool CipherContext::decrypt(const BlockKey256 &key, BytesView data,
 		const Callback<void(BytesView)> &cb) {
-	auto backend = BackendCtx::get(b);
-	if (!backend || !backend->decryptBlock) {
+	if (data.size() < sizeof(BlockCryptoHeader)) {
 		return false;
 	}
-	return backend->decryptBlock(key, data, cb);
+
+	auto info = getBlockInfo(data);
+	if (info.cipher != key.cipher) {
+		auto tmp = key;
+		tmp.cipher = info.cipher;
+		auto success = setKey(tmp);
+		CipherContext_zeroize(tmp.data.data(), tmp.data.size());
+		if (!success) {
+			return false;
+		}
+	} else if (!setKey(key)) {
+		return false;
+	}
+	return decrypt(data, cb);
+}
+
+void CipherContext::clear() {
+	if (_block) {
+		auto backend = static_cast<BackendCtx *>(_block->backendCtx);
+		if (backend && backend->blockFree) {
+			backend->blockFree(*_block);
+		}
+		CipherContext_zeroize(_block->key.data.data(), _block->key.data.size());
+		delete _block;
+		_block = nullptr;
+	}
+	_loaded = false;
+}
+
+Backend CipherContext::getBackend() const {
+	if (_block) {
+		if (auto backend = static_cast<BackendCtx *>(_block->backendCtx)) {
+			return backend->name;
+		}
+	}
+	return _backend;
+}
+
+// one-shot functions use temporary context, so no key material outlives the call
+bool encryptBlock(const BlockKey256 &key, BytesView data, const Callback<void(BytesView)> &cb) {
+	return CipherContext(Backend::Default).encrypt(key, data, cb);
+}
+
+bool encryptBlock(Backend b, const BlockKey256 &key, BytesView data,
+		const Callback<void(BytesView)> &cb) {
+	return CipherContext(b).encrypt(key, data, cb);
+}
+
+bool decryptBlock(const BlockKey256 &key, BytesView data, const Callback<void(BytesView)> &cb) {
+	return CipherContext(Backend::Default).decrypt(key, data, cb);
+}
+
+bool decryptBlock(Backend b, const BlockKey256 &key, BytesView data,
+		const Callback<void(BytesView)> &cb) {
+	return CipherContext(b).decrypt(key, data, cb);
+}
+
+bool encryptBlock(CipherContext &ctx, const BlockKey256 &key, BytesView data,
+		const Callback<void(BytesView)> &cb) {
+	return ctx.encrypt(key, data, cb);
+}
+
+bool decryptBlock(CipherContext &ctx, const BlockKey256 &key, BytesView data,
+		const Callback<void(BytesView)> &cb) {
+	return ctx.decrypt(key, data, cb);
 }
 
 BlockKey256 makeBlockKey(Backend b, BytesView pkey, BytesView hash, BlockCipher c,
@@ -105,6 +105,10 @@ public:
 		crypto::PublicKey *pub;
 		crypto::PrivateKey *priv;
 		BytesView secret;
+
+		// optional caller-owned context, reused for all tokens, that are parsed or exported
+		// with these keys; every token has its own key, so context saves only backend setup
+		crypto::CipherContext *cipher = nullptr;
 	};
 
 	// struct to pass identity data to fingerprinting algorithm
@@ -134,7 +138,7 @@ protected:
 	static std::array<uint8_t, 64> getFingerprint(const Fingerprint &, Time t, BytesView secret);
 
 	Bytes encryptAes(const crypto::BlockKey256 &, const Value &) const;
-	static Value decryptAes(const crypto::BlockKey256 &, BytesView);
+	static Value decryptAes(crypto::CipherContext *, const crypto::BlockKey256 &, BytesView);
 
 	AesToken();
 	AesToken(Keys keys);
@@ -455,7 +459,7 @@ AesToken<Interface> AesToken<Interface>::parse(StringView token, const Fingerpri
 				aesKey = crypto::makeBlockKey(keys.secret, BytesView(fp.data(), fp.size()), v.cipher, v.version);
 			}
 
-			auto p = decryptAes(aesKey, input.payload.getBytes("p"));
+			auto p = decryptAes(keys.cipher, aesKey, input.payload.getBytes("p"));
 			if (p) {
 				return AesToken(move(p), keys);
 			}
@@ -479,7 +483,7 @@ AesToken<Interface> AesToken<Interface>::parse(const Value &payload, const Finge
 			aesKey = crypto::makeBlockKey(keys.secret, BytesView(fp.data(), fp.size()), v.cipher, v.version);
 		}
 
-		auto p = decryptAes(aesKey, payload.getBytes("p"));
+		auto p = decryptAes(keys.cipher, aesKey, payload.getBytes("p"));
 		if (p) {
 			return AesToken(move(p), keys);
 		}
@@ -587,18 +591,28 @@ template <typename Interface>
 auto AesToken<Interface>::encryptAes(const crypto::BlockKey256 &key, const Value &val) const -> Bytes {
 	auto d = data::write<Interface>(val, data::EncodeFormat::CborCompressed);
 	Bytes out;
-	crypto::encryptBlock(key, d, [&] (BytesView data) {
+	auto cb = [&] (BytesView data) {
 		out = data.bytes<Interface>();
-	});
+	};
+	if (_keys.cipher) {
+		crypto::encryptBlock(*_keys.cipher, key, d, cb);
+	} else {
+		crypto::encryptBlock(key, d, cb);
+	}
 	return out;
 }
 
 template <typename Interface>
-auto AesToken<Interface>::decryptAes(const crypto::BlockKey256 &key, BytesView val) -> Value {
+auto AesToken<Interface>::decryptAes(crypto::CipherContext *ctx, const crypto::BlockKey256 &key, BytesView val) -> Value {
 	Value out;
-	crypto::decryptBlock(key, val, [&] (BytesView data) {
+	auto cb = [&] (BytesView data) {
 		out = data::read<Interface>(data);
-	});
+	};
+	if (ctx) {
+		crypto::decryptBlock(*ctx, key, val, cb);
+	} else {
+		crypto::decryptBlock(key, val, cb);
+	}
 	return out;
 }
 
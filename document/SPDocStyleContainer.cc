@@ -23,7 +23,7 @@
 
 #include "SPDocStyleContainer.h"
 #include "SPString.h"
-#include "SPFilesystem.h"
+#include "SPFilesystemCache.h"
 
 namespace STAPPLER_VERSIONIZED stappler::document {
 
@@ -534,9 +534,9 @@ bool StyleContainer::readStyle(StringReader &s) {
 }
 
 bool StyleContainer::readStyle(FileInfo path) {
-	if (filesystem::exists(path)) {
-		auto d = filesystem::readIntoMemory<memory::StandartInterface>(path);
-		StringReader r((const char *)d.data(), d.size());
+	if (auto d = filesystem::FileCache::getInstance()->read(path)) {
+		auto str = d->getString();
+		StringReader r(str.data(), str.size());
 		return readStyle(r);
 	}
 	return false;
@@ -173,7 +173,8 @@ bool DocumentEpub::processArchiveFiles(EpubData *epubData) {
 				auto fontIt =
 						epubData->fonts.emplace(it.second.path, DocumentFont(it.second.path)).first;
 				fontIt->second.ct = it.second.type;
-				fontIt->second.data = data;
+				// preserve extracted file in memory
+				fontIt->second.data = data.pdup();
 			});
 		} else if (it.second.type.starts_with("text/html")
 				|| it.second.type.starts_with("application/xhtml+xml")) {
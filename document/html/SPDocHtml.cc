@@ -25,6 +25,7 @@
 #include "SPDocFormat.h"
 #include "SPDocHtml.h"
 #include "SPDocPageContainer.h"
+#include "SPFilesystemCache.h"
 
 namespace STAPPLER_VERSIONIZED stappler::document {
 
@@ -288,8 +289,8 @@ bool DocumentHtml::init(FileInfo path, StringView ct) {
 		return false;
 	}
 
-	auto data = filesystem::readIntoMemory<memory::PoolInterface>(path);
-	return read(data, ct);
+	auto data = filesystem::FileCache::getInstance()->read(path);
+	return data && read(data->getBytes(), ct);
 }
 
 bool DocumentHtml::init(BytesView data, StringView ct) {
@@ -305,8 +306,8 @@ bool DocumentHtml::init(memory::pool_t *pool, FileInfo path, StringView ct) {
 		return false;
 	}
 
-	auto data = filesystem::readIntoMemory<memory::PoolInterface>(path);
-	return read(data, ct);
+	auto data = filesystem::FileCache::getInstance()->read(path);
+	return data && read(data->getBytes(), ct);
 }
 
 bool DocumentHtml::init(memory::pool_t *pool, BytesView data, StringView ct) {
@@ -530,6 +530,42 @@ bool ftw(const FileInfo &info, const Callback<bool(const FileInfo &, FileType)>
 	}
 }
 
+bool ftw_stat(const FileInfo &info, const Callback<bool(const FileInfo &, const Stat &)> &cb,
+		const FtwConfig &cfg) {
+	if (filepath::isEmpty(info)) {
+		return false;
+	}
+
+	auto fn = [&](StringView p, const Stat &stat) {
+		auto tmpPath = filepath::merge<memory::StandartInterface>(info.path, p);
+		FileInfo newInfo = info;
+		newInfo.path = tmpPath;
+		return cb(newInfo, stat);
+	};
+
+	if (hasFlag(getCategoryFlags(info.category), CategoryFlags::PlatformSpecific)) {
+		// platform walkers reports only types, so other fields are requested one by one
+		return filesystem::platform::_ftw(info.category, info.path,
+					   [&](StringView p, FileType type) {
+			Stat stat;
+			if ((cfg.fields & ~StatFields::Type) != StatFields::None) {
+				filesystem::platform::_stat(info.category,
+						filepath::merge<memory::StandartInterface>(info.path, p), stat);
+			}
+			stat.type = type;
+			return fn(p, stat);
+		}, cfg.depth, cfg.dirFirst)
+				== Status::Ok;
+	} else {
+		bool found = false;
+		enumeratePaths(info, Access::Exists, [&](StringView str, FileFlags) {
+			found = filesystem::native::ftw_stat_fn(str, fn, cfg) == Status::Ok;
+			return false;
+		});
+		return found;
+	}
+}
+
 bool move(const FileInfo &isource, const FileInfo &idest) {
 	if (isource.path.empty() || idest.path.empty()) {
 		return false;
@@ -30,6 +30,12 @@
 #include "SPFilepath.h"
 #include "SPLog.h" // IWYU pragma: keep
 
+namespace STAPPLER_VERSIONIZED stappler::thread {
+
+class ThreadPool;
+
+}
+
 namespace STAPPLER_VERSIONIZED stappler::filesystem {
 
 enum class CategoryFlags : uint32_t {
@@ -103,6 +109,32 @@ struct Stat {
 	Time ctime;
 	Time mtime;
 	Time atime;
+
+	// file identity (device and inode), zero when not provided by platform
+	uint64_t dev = 0;
+	uint64_t ino = 0;
+};
+
+// Stat fields, that should be filled by `ftw_stat`
+enum class StatFields : uint32_t {
+	None = 0,
+	Type = 1 << 0,
+	Size = 1 << 1,
+	Prot = 1 << 2,
+	Owner = 1 << 3, // user and group
+	Times = 1 << 4, // ctime, mtime and atime
+	All = Type | Size | Prot | Owner | Times,
+};
+
+SP_DEFINE_ENUM_AS_MASK(StatFields)
+
+struct FtwConfig {
+	int depth = -1;
+	bool dirFirst = false;
+	StatFields fields = StatFields::Type;
+
+	// when set, subdirectories are listed in parallel on pool's workers
+	thread::ThreadPool *threadPool = nullptr;
 };
 
 class SP_PUBLIC File final {
@@ -258,6 +290,21 @@ SP_PUBLIC bool remove(const FileInfo &, bool recursive = false, bool withDirs =
 SP_PUBLIC bool ftw(const FileInfo &, const Callback<bool(const FileInfo &, FileType)> &,
 		int depth = -1, bool dirFirst = false);
 
+// file-tree-walk for large trees, reports Stat with requested fields for each file or directory
+// (fields, that was not requested, can be filled or left default)
+// On Linux, directories are read with large getdents64 batches, and statx is called only when
+// requested fields can not be taken from directory entry
+//
+// Callback ordering:
+// - callback is never called concurrently, but can be called from pool's worker threads
+// - entries within single directory are reported in directory order
+// - with dirFirst, directory is reported before any entry inside it, otherwise after all entries of its subtree
+// - no order is guaranteed between sibling subdirectories (even without thread pool, they are processed as a stack)
+// - when callback returns false, walk stops as soon as possible and no more callbacks will be called
+// Subdirectory, that can not be opened, is still reported, but its contents are skipped, and ftw_stat returns false
+SP_PUBLIC bool ftw_stat(const FileInfo &, const Callback<bool(const FileInfo &, const Stat &)> &,
+		const FtwConfig & = FtwConfig());
+
 // returns application current work dir from getcwd (or path inside current dir, if path is set
 // if relative == false - do not merge paths, if provided path is absolute
 //
@@ -503,6 +550,10 @@ SP_PUBLIC Status touch_fn(StringView path);
 SP_PUBLIC Status ftw_fn(StringView path, const Callback<bool(StringView, FileType)> &, int depth,
 		bool dirFirst);
 
+// Callback returns relative paths, not absolute; see filesystem::ftw_stat for ordering guarantees
+SP_PUBLIC Status ftw_stat_fn(StringView path, const Callback<bool(StringView, const Stat &)> &,
+		const FtwConfig &);
+
 SP_PUBLIC Status rename_fn(StringView source, StringView dest);
 
 SP_PUBLIC FILE *fopen_fn(StringView, StringView mode);
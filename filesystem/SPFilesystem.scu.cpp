@@ -30,6 +30,7 @@ THE SOFTWARE.
 #include "SPFilesystemNativeWin32.cc"
 #include "SPFilesystem.cc"
 #include "SPFilesystemMime.cc"
+#include "SPFilesystemCache.cc"
 
 #include "platform/SPFilesystem-android.cc"
 #include "platform/SPFilesystem-linux.cc"
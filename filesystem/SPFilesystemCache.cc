@@ -0,0 +1,272 @@
+/**
+ Copyright (c) 2025 Stappler LLC <admin@stappler.dev>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ **/
+
+#include "SPFilesystemCache.h"
+
+#include <list>
+
+namespace STAPPLER_VERSIONIZED stappler::filesystem {
+
+struct FileCacheKey {
+	uint64_t dev = 0;
+	uint64_t ino = 0;
+
+	// only when file identity is not available
+	FileCategory category = FileCategory::Custom;
+	memory::StandartInterface::StringType path;
+
+	auto operator<=>(const FileCacheKey &) const = default;
+};
+
+struct FileCacheEntry {
+	FileCacheKey key;
+	Rc<FileCacheData> data;
+};
+
+using FileCacheList = std::list<FileCacheEntry>;
+
+struct FileCache::Data {
+	mutable std::mutex mutex;
+
+	// most recently used entries first
+	FileCacheList list;
+	memory::StandartInterface::MapType<FileCacheKey, FileCacheList::iterator> entries;
+
+	size_t budget = DefaultBudget;
+	size_t mappingThreshold = NoMapping;
+	size_t size = 0;
+
+	Rc<FileCacheData> get(const FileCacheKey &key, const Stat &stat) {
+		std::unique_lock lock(mutex);
+		auto it = entries.find(key);
+		if (it == entries.end()) {
+			return nullptr;
+		}
+
+		auto &cached = it->second->data->getStat();
+		if (cached.mtime != stat.mtime || cached.size != stat.size) {
+			erase(it);
+			return nullptr;
+		}
+
+		list.splice(list.begin(), list, it->second);
+		return it->second->data;
+	}
+
+	void insert(FileCacheKey &&key, const Rc<FileCacheData> &data) {
+		std::unique_lock lock(mutex);
+		if (data->getBytes().size() > budget) {
+			return;
+		}
+
+		auto it = entries.find(key);
+		if (it != entries.end()) {
+			erase(it);
+		}
+
+		list.emplace_front(FileCacheEntry{key, data});
+		entries.emplace(sp::move(key), list.begin());
+		size += data->getBytes().size();
+
+		shrink();
+	}
+
+	void erase(decltype(entries)::iterator it) {
+		size -= it->second->data->getBytes().size();
+		list.erase(it->second);
+		entries.erase(it);
+	}
+
+	void shrink() {
+		while (size > budget && !list.empty()) {
+			erase(entries.find(list.back().key));
+		}
+	}
+};
+
+// resolves readable regular file the same way, as openForReading does
+static bool FileCache_resolve(const FileInfo &info, Stat &stat,
+		memory::StandartInterface::StringType &nativePath) {
+	if (info.path.empty()) {
+		return false;
+	}
+
+	if (hasFlag(getCategoryFlags(info.category), CategoryFlags::PlatformSpecific)) {
+		return platform::_stat(info.category, info.path, stat) && stat.type == FileType::File;
+	}
+
+	bool found = false;
+	enumeratePaths(info, Access::Read, [&](StringView str, FileFlags) {
+		if (native::stat_fn(str, stat) == Status::Ok && stat.type == FileType::File) {
+			nativePath = str.str<memory::StandartInterface>();
+			found = true;
+			return false;
+		}
+		return true; // try another
+	});
+	return found;
+}
+
+static FileCacheKey FileCache_makeKey(const FileInfo &info, const Stat &stat,
+		StringView nativePath) {
+	FileCacheKey key;
+	if (!nativePath.empty() && stat.ino != 0) {
+		key.dev = stat.dev;
+		key.ino = stat.ino;
+	} else if (!nativePath.empty()) {
+		key.path = nativePath.str<memory::StandartInterface>();
+	} else {
+		key.category = info.category;
+		key.path = info.path.str<memory::StandartInterface>();
+	}
+	return key;
+}
+
+FileCacheData::FileCacheData(const Stat &stat, memory::StandartInterface::BytesType &&bytes)
+: _stat(stat), _bytes(sp::move(bytes)) {
+	_view = BytesView(_bytes.data(), _bytes.size());
+}
+
+FileCacheData::FileCacheData(const Stat &stat, MemoryMappedRegion &&region)
+: _stat(stat), _region(sp::move(region)) {
+	_view = _region->getView();
+}
+
+FileCache *FileCache::getInstance() {
+	static FileCache *s_sharedInstance = new FileCache();
+	return s_sharedInstance;
+}
+
+FileCache::FileCache(size_t budget, size_t mappingThreshold) : _data(new Data) {
+	_data->budget = budget;
+	_data->mappingThreshold = mappingThreshold;
+}
+
+FileCache::~FileCache() { delete _data; }
+
+Rc<FileCacheData> FileCache::read(const FileInfo &info) {
+	Stat stat;
+	memory::StandartInterface::StringType nativePath;
+	if (!FileCache_resolve(info, stat, nativePath)) {
+		// stale entry for removed file will be evicted by LRU
+		return nullptr;
+	}
+
+	auto key = FileCache_makeKey(info, stat, nativePath);
+	if (auto data = _data->get(key, stat)) {
+		return data;
+	}
+
+	// file is read without lock, concurrent reads for the same file can be performed,
+	// last one replaces cached entry
+	Rc<FileCacheData> data;
+	if (!nativePath.empty() && stat.size > 0 && stat.size >= getMappingThreshold()) {
+		auto region = MemoryMappedRegion::mapFile(FileInfo(nativePath), MappingType::Private,
+				ProtFlags::MapRead);
+		if (region && region.getSize() == stat.size) {
+			data = Rc<FileCacheData>::alloc(stat, sp::move(region));
+		}
+	}
+
+	if (!data) {
+		auto f = nativePath.empty() ? openForReading(info)
+									: File(native::fopen_fn(nativePath, "rb"));
+		if (!f) {
+			return nullptr;
+		}
+
+		auto bytes = f.readIntoMemory<memory::StandartInterface>();
+		f.close();
+
+		if (bytes.size() != stat.size) {
+			// file was modified while reading, do not cache it
+			stat.size = bytes.size();
+			return Rc<FileCacheData>::alloc(stat, sp::move(bytes));
+		}
+
+		data = Rc<FileCacheData>::alloc(stat, sp::move(bytes));
+	}
+
+	if (!nativePath.empty()) {
+		Stat check;
+		if (native::stat_fn(nativePath, check) != Status::Ok || check.mtime != stat.mtime
+				|| check.size != stat.size) {
+			return data;
+		}
+	}
+
+	_data->insert(sp::move(key), data);
+	return data;
+}
+
+void FileCache::drop(const FileInfo &info) {
+	Stat stat;
+	memory::StandartInterface::StringType nativePath;
+	FileCacheKey key;
+	if (FileCache_resolve(info, stat, nativePath)) {
+		key = FileCache_makeKey(info, stat, nativePath);
+	} else {
+		key.category = info.category;
+		key.path = info.path.str<memory::StandartInterface>();
+	}
+
+	std::unique_lock lock(_data->mutex);
+	auto it = _data->entries.find(key);
+	if (it != _data->entries.end()) {
+		_data->erase(it);
+	}
+}
+
+void FileCache::clear() {
+	std::unique_lock lock(_data->mutex);
+	_data->entries.clear();
+	_data->list.clear();
+	_data->size = 0;
+}
+
+void FileCache::setBudget(size_t budget) {
+	std::unique_lock lock(_data->mutex);
+	_data->budget = budget;
+	_data->shrink();
+}
+
+size_t FileCache::getBudget() const {
+	std::unique_lock lock(_data->mutex);
+	return _data->budget;
+}
+
+void FileCache::setMappingThreshold(size_t threshold) {
+	std::unique_lock lock(_data->mutex);
+	_data->mappingThreshold = threshold;
+}
+
+size_t FileCache::getMappingThreshold() const {
+	std::unique_lock lock(_data->mutex);
+	return _data->mappingThreshold;
+}
+
+size_t FileCache::getSize() const {
+	std::unique_lock lock(_data->mutex);
+	return _data->size;
+}
+
+} // namespace stappler::filesystem
@@ -0,0 +1,111 @@
+/**
+ Copyright (c) 2025 Stappler LLC <admin@stappler.dev>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ **/
+
+#ifndef STAPPLER_FILESYSTEM_SPFILESYSTEMCACHE_H_
+#define STAPPLER_FILESYSTEM_SPFILESYSTEMCACHE_H_
+
+#include "SPFilesystem.h"
+#include "SPRef.h"
+
+namespace STAPPLER_VERSIONIZED stappler::filesystem {
+
+// Immutable contents of a file, shared between all users of FileCache
+// Data stays valid while reference is held, even if it was evicted from cache
+class SP_PUBLIC FileCacheData final : public Ref {
+public:
+	FileCacheData(const Stat &, memory::StandartInterface::BytesType &&);
+	FileCacheData(const Stat &, MemoryMappedRegion &&);
+
+	// stat, that was used to validate contents
+	const Stat &getStat() const { return _stat; }
+
+	BytesView getBytes() const { return _view; }
+	StringView getString() const {
+		return StringView(reinterpret_cast<const char *>(_view.data()), _view.size());
+	}
+
+	bool isMapped() const { return _region.has_value(); }
+
+protected:
+	Stat _stat;
+	BytesView _view;
+	memory::StandartInterface::BytesType _bytes;
+	std::optional<MemoryMappedRegion> _region;
+};
+
+// Read cache for file contents with LRU byte budget
+//
+// Entries are keyed by file identity (device and inode, or by path, when platform can not
+// provide identity), and validated by mtime and size with a single stat on every read.
+// By default, contents are always copied into memory. Mapping is opt-in: with mapping threshold
+// set, files, that are not smaller then threshold, are mapped instead of read. Mapped contents
+// reflect in-place writes into file, and access to them raises SIGBUS, when file was truncated,
+// so mapping should be enabled only for files, that are replaced atomically (with rename).
+//
+// Thread-safe
+class SP_PUBLIC FileCache final {
+public:
+	static constexpr size_t DefaultBudget = 64_MiB;
+
+	// threshold, that disables mapping
+	static constexpr size_t NoMapping = maxOf<size_t>();
+
+	// recommended threshold for caches, that enable mapping
+	static constexpr size_t DefaultMappingThreshold = 1_MiB;
+
+	// process-wide cache, shared by documents, templates and other file consumers;
+	// it does not map files, consumers, that need mapping, should use their own cache
+	static FileCache *getInstance();
+
+	FileCache(size_t budget = DefaultBudget, size_t mappingThreshold = NoMapping);
+	~FileCache();
+
+	FileCache(const FileCache &) = delete;
+	FileCache &operator=(const FileCache &) = delete;
+
+	// returns contents of a regular file, or nullptr, if file can not be read
+	// file is read from disk only when it's not in cache or was modified
+	Rc<FileCacheData> read(const FileInfo &);
+
+	void drop(const FileInfo &);
+	void clear();
+
+	// evicts least recently used entries, if budget was decreased
+	void setBudget(size_t);
+	size_t getBudget() const;
+
+	// NoMapping disables mapping; should not be changed for shared instance
+	void setMappingThreshold(size_t);
+	size_t getMappingThreshold() const;
+
+	// size of all cached entries
+	size_t getSize() const;
+
+protected:
+	struct Data;
+
+	Data *_data = nullptr;
+};
+
+} // namespace stappler::filesystem
+
+#endif /* STAPPLER_FILESYSTEM_SPFILESYSTEMCACHE_H_ */
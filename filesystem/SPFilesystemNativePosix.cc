@@ -32,6 +32,14 @@ THE SOFTWARE.
 #include <dirent.h>
 #include <sys/stat.h>
 
+#if LINUX
+#include <sys/syscall.h>
+#endif
+
+#if MODULE_STAPPLER_THREADS
+#include "SPThreadPool.h"
+#endif
+
 #ifndef WIN32
 
 namespace STAPPLER_VERSIONIZED stappler::filesystem::native {
@@ -152,6 +160,25 @@ static mode_t getModeFormProtFlags(ProtFlags flags) {
 	return ret;
 }
 
+static FileType getFileTypeFromMode(mode_t m) {
+	if (S_ISBLK(m)) {
+		return FileType::BlockDevice;
+	} else if (S_ISCHR(m)) {
+		return FileType::CharDevice;
+	} else if (S_ISDIR(m)) {
+		return FileType::Dir;
+	} else if (S_ISFIFO(m)) {
+		return FileType::Pipe;
+	} else if (S_ISREG(m)) {
+		return FileType::File;
+	} else if (S_ISLNK(m)) {
+		return FileType::Link;
+	} else if (S_ISSOCK(m)) {
+		return FileType::Socket;
+	}
+	return FileType::Unknown;
+}
+
 Status remove_fn(StringView path) {
 	if (!path.starts_with("/")) {
 		log::source().error("filesystem",
@@ -254,23 +281,7 @@ Status stat_fn(StringView path, Stat &stat) {
 	if (::stat(SP_TERMINATED_DATA(path), &s) == 0) {
 		stat.size = size_t(s.st_size);
 
-		if (S_ISBLK(s.st_mode)) {
-			stat.type = FileType::BlockDevice;
-		} else if (S_ISCHR(s.st_mode)) {
-			stat.type = FileType::CharDevice;
-		} else if (S_ISDIR(s.st_mode)) {
-			stat.type = FileType::Dir;
-		} else if (S_ISFIFO(s.st_mode)) {
-			stat.type = FileType::Pipe;
-		} else if (S_ISREG(s.st_mode)) {
-			stat.type = FileType::File;
-		} else if (S_ISLNK(s.st_mode)) {
-			stat.type = FileType::Link;
-		} else if (S_ISSOCK(s.st_mode)) {
-			stat.type = FileType::Socket;
-		} else {
-			stat.type = FileType::Unknown;
-		}
+		stat.type = getFileTypeFromMode(s.st_mode);
 
 		stat.prot = getProtFlagsFromMode(s.st_mode);
 
@@ -281,6 +292,9 @@ Status stat_fn(StringView path, Stat &stat) {
 		stat.ctime = Time::microseconds(s.st_ctim.tv_sec * 1'000'000 + s.st_ctim.tv_nsec / 1'000);
 		stat.mtime = Time::microseconds(s.st_mtim.tv_sec * 1'000'000 + s.st_mtim.tv_nsec / 1'000);
 
+		stat.dev = uint64_t(s.st_dev);
+		stat.ino = uint64_t(s.st_ino);
+
 		return Status::Ok;
 	}
 	return sprt::status::errnoToStatus(errno);
@@ -412,6 +426,346 @@ Status ftw_fn(StringView path, const Callback<bool(StringView, FileType)> &callb
 	return _ftw_fn(dirfd, StringView(), callback, depth, dirFirst);
 }
 
+#if LINUX
+
+// getdents64 record, glibc does not expose it for all supported versions
+struct FtwDirent64 {
+	uint64_t d_ino;
+	int64_t d_off;
+	unsigned short d_reclen;
+	unsigned char d_type;
+	char d_name[1];
+};
+
+#endif
+
+static FileType getFileTypeFromDirent(unsigned char t) {
+	switch (t) {
+	case DT_BLK: return FileType::BlockDevice; break;
+	case DT_CHR: return FileType::CharDevice; break;
+	case DT_FIFO: return FileType::Pipe; break;
+	case DT_LNK: return FileType::Link; break;
+	case DT_REG: return FileType::File; break;
+	case DT_DIR: return FileType::Dir; break;
+	case DT_SOCK: return FileType::Socket; break;
+	default: break;
+	}
+	return FileType::Unknown;
+}
+
+// Directory, that waits for its own listing and for all subdirectories, that was queued from it
+//
+// Directory is opened only when it's claimed from queue (relative to parent's fd, that stays open
+// until all subdirectories are completed), so number of open descriptors depends on tree depth
+// and number of threads, not on number of queued directories
+struct FtwStatNode {
+	FtwStatNode *parent = nullptr;
+	int fd = -1;
+	int depth = -1;
+	memory::StandartInterface::StringType name;
+	memory::StandartInterface::StringType path;
+	Stat stat;
+	std::atomic<uint32_t> pending = 1;
+};
+
+struct FtwStatContext : public Ref {
+	static constexpr size_t BufferSize = 64 * 1'024;
+
+	const Callback<bool(StringView, const Stat &)> *callback = nullptr;
+	bool dirFirst = false;
+	StatFields fields = StatFields::None;
+
+	std::atomic<bool> stopped = false;
+	std::atomic<Status> error = Status::Ok;
+
+	std::mutex callbackMutex;
+
+	std::mutex queueMutex;
+	std::condition_variable queueCond;
+	memory::StandartInterface::VectorType<FtwStatNode *> queue;
+	size_t active = 0;
+
+	bool report(StringView path, const Stat &stat) {
+		if (stopped.load(std::memory_order_relaxed)) {
+			return false;
+		}
+
+		std::unique_lock lock(callbackMutex);
+		if (!stopped.load(std::memory_order_relaxed) && !(*callback)(path, stat)) {
+			stopped.store(true);
+		}
+		return !stopped.load(std::memory_order_relaxed);
+	}
+
+	// when node is a last holder of its parent, parent is completed too
+	void complete(FtwStatNode *node) {
+		while (node && node->pending.fetch_sub(1) == 1) {
+			if (!dirFirst) {
+				report(node->path, node->stat);
+			}
+			if (node->fd >= 0) {
+				::close(node->fd);
+			}
+			auto parent = node->parent;
+			delete node;
+			node = parent;
+		}
+	}
+
+	bool needStat(FileType type) const {
+		return type == FileType::Unknown || (fields & ~StatFields::Type) != StatFields::None;
+	}
+
+	void stat(int dirfd, const char *name, Stat &stat) const {
+#if LINUX
+		unsigned mask = STATX_TYPE;
+		if (hasFlag(fields, StatFields::Size)) {
+			mask |= STATX_SIZE;
+		}
+		if (hasFlag(fields, StatFields::Prot)) {
+			mask |= STATX_MODE;
+		}
+		if (hasFlag(fields, StatFields::Owner)) {
+			mask |= STATX_UID | STATX_GID;
+		}
+		if (hasFlag(fields, StatFields::Times)) {
+			mask |= STATX_ATIME | STATX_CTIME | STATX_MTIME;
+		}
+
+		struct statx s;
+		auto flags = AT_SYMLINK_NOFOLLOW | AT_NO_AUTOMOUNT | (name[0] ? 0 : AT_EMPTY_PATH);
+		if (::statx(dirfd, name, flags, mask, &s) != 0) {
+			return;
+		}
+
+		if (s.stx_mask & STATX_TYPE) {
+			stat.type = getFileTypeFromMode(s.stx_mode);
+		}
+		if (s.stx_mask & STATX_SIZE) {
+			stat.size = size_t(s.stx_size);
+		}
+		if (s.stx_mask & STATX_MODE) {
+			stat.prot = getProtFlagsFromMode(s.stx_mode);
+		}
+		if (s.stx_mask & STATX_UID) {
+			stat.user = s.stx_uid;
+		}
+		if (s.stx_mask & STATX_GID) {
+			stat.group = s.stx_gid;
+		}
+		if (s.stx_mask & STATX_ATIME) {
+			stat.atime = Time::microseconds(
+					s.stx_atime.tv_sec * 1'000'000 + s.stx_atime.tv_nsec / 1'000);
+		}
+		if (s.stx_mask & STATX_CTIME) {
+			stat.ctime = Time::microseconds(
+					s.stx_ctime.tv_sec * 1'000'000 + s.stx_ctime.tv_nsec / 1'000);
+		}
+		if (s.stx_mask & STATX_MTIME) {
+			stat.mtime = Time::microseconds(
+					s.stx_mtime.tv_sec * 1'000'000 + s.stx_mtime.tv_nsec / 1'000);
+		}
+#else
+		struct stat s;
+		if ((name[0] ? ::fstatat(dirfd, name, &s, AT_SYMLINK_NOFOLLOW) : ::fstat(dirfd, &s))
+				!= 0) {
+			return;
+		}
+
+		stat.type = getFileTypeFromMode(s.st_mode);
+		stat.size = size_t(s.st_size);
+		stat.prot = getProtFlagsFromMode(s.st_mode);
+		stat.user = s.st_uid;
+		stat.group = s.st_gid;
+		stat.atime = Time::microseconds(s.st_atim.tv_sec * 1'000'000 + s.st_atim.tv_nsec / 1'000);
+		stat.ctime = Time::microseconds(s.st_ctim.tv_sec * 1'000'000 + s.st_ctim.tv_nsec / 1'000);
+		stat.mtime = Time::microseconds(s.st_mtim.tv_sec * 1'000'000 + s.st_mtim.tv_nsec / 1'000);
+#endif
+	}
+
+	void push(FtwStatNode *node) {
+		std::unique_lock lock(queueMutex);
+		queue.emplace_back(node);
+		queueCond.notify_one();
+	}
+
+	// walk continues with other directories, but error is returned as result
+	void fail(FtwStatNode *node, Status status) {
+		log::source().error("filesystem", "ftw_stat: fail to open directory '", node->path,
+				"': ", status);
+
+		auto expected = Status::Ok;
+		error.compare_exchange_strong(expected, status);
+	}
+
+	void open(FtwStatNode *node) {
+		if (node->fd >= 0) {
+			return;
+		}
+
+		node->fd = ::openat(node->parent->fd, node->name.data(), OpenDirFlags);
+		if (node->fd < 0) {
+			fail(node, sprt::status::errnoToStatus(errno));
+		}
+	}
+
+	void entry(FtwStatNode *node, const char *name, unsigned char dtype) {
+		if (name[0] == '.' && (name[1] == 0 || (name[1] == '.' && name[2] == 0))) {
+			return;
+		}
+
+		if (stopped.load(std::memory_order_relaxed)) {
+			return;
+		}
+
+		Stat st;
+		st.type = getFileTypeFromDirent(dtype);
+		if (needStat(st.type)) {
+			stat(node->fd, name, st);
+		}
+
+		memory::StandartInterface::StringType path;
+		if (node->path.empty()) {
+			path = name;
+		} else {
+			path = filepath::merge<memory::StandartInterface>(node->path, name);
+		}
+
+		if (st.type == FileType::Dir && node->depth != 1) {
+			auto child = new FtwStatNode;
+			child->parent = node;
+			child->depth = (node->depth < 0) ? node->depth : node->depth - 1;
+			child->name = name;
+			child->path = sp::move(path);
+			child->stat = st;
+			node->pending.fetch_add(1);
+			push(child);
+			return;
+		}
+
+		report(path, st);
+	}
+
+	void list(FtwStatNode *node, uint8_t *buf) {
+		if (dirFirst && !report(node->path, node->stat)) {
+			return;
+		}
+
+		if (node->depth == 0) {
+			return;
+		}
+
+		open(node);
+		if (node->fd < 0) {
+			return;
+		}
+
+#if LINUX
+		while (!stopped.load(std::memory_order_relaxed)) {
+			auto nread = ::syscall(SYS_getdents64, node->fd, buf, BufferSize);
+			if (nread <= 0) {
+				break;
+			}
+
+			for (long offset = 0; offset < nread && !stopped.load(std::memory_order_relaxed);) {
+				auto d = (const FtwDirent64 *)(buf + offset);
+				entry(node, d->d_name, d->d_type);
+				offset += d->d_reclen;
+			}
+		}
+#else
+		auto dp = ::fdopendir(::dup(node->fd));
+		if (!dp) {
+			return;
+		}
+
+		struct dirent *d;
+		while (!stopped.load(std::memory_order_relaxed) && (d = ::readdir(dp))) {
+			entry(node, d->d_name, d->d_type);
+		}
+		::closedir(dp);
+#endif
+	}
+
+	// Every thread (including caller) claims directories from shared queue,
+	// walk ends when queue is empty and no thread is listing a directory
+	void run() {
+		memory::StandartInterface::BytesType buf;
+		buf.resize(BufferSize);
+
+		std::unique_lock lock(queueMutex);
+		while (true) {
+			queueCond.wait(lock, [&] { return !queue.empty() || active == 0; });
+			if (queue.empty()) {
+				queueCond.notify_all();
+				return;
+			}
+
+			auto node = queue.back();
+			queue.pop_back();
+			++active;
+			lock.unlock();
+
+			if (!stopped.load(std::memory_order_relaxed)) {
+				list(node, buf.data());
+			}
+			complete(node);
+
+			lock.lock();
+			--active;
+			if (queue.empty() && active == 0) {
+				queueCond.notify_all();
+			}
+		}
+	}
+};
+
+Status ftw_stat_fn(StringView path, const Callback<bool(StringView, const Stat &)> &callback,
+		const FtwConfig &cfg) {
+	if (!path.starts_with("/")) {
+		log::source().error("filesystem",
+				"filesystem::native::ftw_stat_fn should be used with absolute paths");
+		return Status::Declined;
+	}
+
+	auto dirfd = ::openat(-1, SP_TERMINATED_DATA(path), OpenDirFlags);
+	if (dirfd < 0) {
+		return sprt::status::errnoToStatus(errno);
+	}
+
+	auto ctx = Rc<FtwStatContext>::alloc();
+	ctx->callback = &callback;
+	ctx->dirFirst = cfg.dirFirst;
+	ctx->fields = cfg.fields;
+
+	auto root = new FtwStatNode;
+	root->fd = dirfd;
+	root->depth = cfg.depth;
+	root->stat.type = FileType::Dir;
+	if (ctx->needStat(FileType::Dir)) {
+		ctx->stat(dirfd, "", root->stat);
+	}
+
+	ctx->queue.emplace_back(root);
+
+#if MODULE_STAPPLER_THREADS
+	if (cfg.threadPool) {
+		// workers, that started after walk was completed, will find empty queue and exit
+		auto ntasks = uint32_t(cfg.threadPool->getInfo().threadCount);
+		for (uint32_t i = 0; i < ntasks; ++i) {
+			cfg.threadPool->perform([ctx] { ctx->run(); }, ctx);
+		}
+	}
+#endif
+
+	ctx->run();
+
+	if (ctx->stopped.load()) {
+		return Status::Suspended;
+	}
+	return ctx->error.load();
+}
+
 Status rename_fn(StringView source, StringView dest) {
 	if (::rename(SP_TERMINATED_DATA(source), SP_TERMINATED_DATA(dest)) == 0) {
 		return Status::Ok;
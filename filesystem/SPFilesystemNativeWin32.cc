@@ -461,6 +461,19 @@ Status ftw_fn(StringView path, const Callback<bool(StringView, FileType)> &callb
 	return ret;
 }
 
+// no batched directory API here, so entries are walked with ftw_fn and requested with stat_fn
+Status ftw_stat_fn(StringView path, const Callback<bool(StringView, const Stat &)> &callback,
+		const FtwConfig &cfg) {
+	return ftw_fn(path, [&](StringView p, FileType type) {
+		Stat stat;
+		if ((cfg.fields & ~StatFields::Type) != StatFields::None) {
+			stat_fn(filepath::merge<memory::StandartInterface>(path, p), stat);
+		}
+		stat.type = type;
+		return callback(p, stat);
+	}, cfg.depth, cfg.dirFirst);
+}
+
 Status rename_fn(StringView source, StringView dest) {
 	memory::StandartInterface::WideStringType wsource = string::toUtf16<memory::StandartInterface>(
 			posixToNative<memory::StandartInterface>(source));
@@ -131,51 +131,57 @@ struct SP_PUBLIC FontAtlasValue {
 	geom::Vec2 tex;
 };
 
+// Values are written once (writers should be serialized externally) and published with
+// release stores, so readers can access storage without locking
 template <typename Value>
 struct SP_PUBLIC FontCharStorage {
-	using CellType = std::array<Value, 256>;
+	static_assert(std::is_trivially_copyable_v<Value>, "Value should be trivially copyable");
 
-	FontCharStorage() { cells.fill(nullptr); }
+	using CellType = std::array<std::atomic<Value>, 256>;
+
+	FontCharStorage() {
+		for (auto &it : cells) { it.store(nullptr, std::memory_order_relaxed); }
+	}
 
 	~FontCharStorage() {
 		for (auto &it : cells) {
-			if (it) {
-				delete it;
-				it = nullptr;
+			if (auto cell = it.load(std::memory_order_relaxed)) {
+				delete cell;
+				it.store(nullptr, std::memory_order_relaxed);
 			}
 		}
 	}
 
 	void emplace(char16_t ch, Value &&value) {
 		auto cellId = ch / 256;
-		if (!cells[cellId]) {
-			cells[cellId] = new CellType;
-			memset(cells[cellId]->data(), 0, cells[cellId]->size() * sizeof(Value));
+		auto cell = cells[cellId].load(std::memory_order_relaxed);
+		if (!cell) {
+			cell = new CellType();
+			cells[cellId].store(cell, std::memory_order_release);
 		}
 
-		(*cells[cellId])[ch % 256] = move(value);
+		(*cell)[ch % 256].store(value, std::memory_order_release);
 	}
 
-	const Value *get(char16_t ch) const {
-		auto cellId = ch / 256;
-		auto cell = cells[cellId];
+	Value get(char16_t ch) const {
+		auto cell = cells[ch / 256].load(std::memory_order_acquire);
 		if (!cell) {
-			return nullptr;
+			return Value();
 		}
-		return &(cell->at(ch % 256));
+		return (*cell)[ch % 256].load(std::memory_order_acquire);
 	}
 
 	template <typename Callback>
-	void foreach (const Callback &cb) {
+	void foreach (const Callback &cb) const {
 		static_assert(std::is_invocable_v<Callback, const Value &>, "Invalid callback type");
 		for (auto &it : cells) {
-			if (it) {
-				for (auto &iit : *it) { cb(iit); }
+			if (auto cell = it.load(std::memory_order_acquire)) {
+				for (auto &iit : *cell) { cb(iit.load(std::memory_order_acquire)); }
 			}
 		}
 	}
 
-	std::array<CellType *, 256> cells;
+	std::array<std::atomic<CellType *>, 256> cells;
 };
 
 inline bool operator<(const CharShape &l, const CharShape &c) { return l.charID < c.charID; }
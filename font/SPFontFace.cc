@@ -42,6 +42,63 @@ static constexpr uint32_t getAxisTag(char c1, char c2, char c3, char c4) {
 
 static constexpr uint32_t getAxisTag(const char c[4]) { return getAxisTag(c[0], c[1], c[2], c[3]); }
 
+// Reads glyph pairs (left << 16 | right) from horizontal format 0 subtables of 'kern' table
+// Both Microsoft (version 0) and Apple (version 1) headers are supported
+static void readKernTablePairs(BytesViewNetwork data, Vector<uint32_t> &pairs) {
+	// returns format 0 subtable size, length field can overflow for large subtables
+	auto readPairs = [&](BytesViewNetwork sub) -> size_t {
+		auto npairs = sub.readUnsigned16();
+		sub += 6; // searchRange, entrySelector, rangeShift
+		for (uint16_t i = 0; i < npairs && sub.size() >= 6; ++i) {
+			auto left = sub.readUnsigned16();
+			auto right = sub.readUnsigned16();
+			sub += 2; // value
+			pairs.emplace_back(uint32_t(left) << 16 | uint32_t(right));
+		}
+		return 8 + size_t(npairs) * 6;
+	};
+
+	auto version = data.readUnsigned16();
+	if (version == 0) {
+		auto ntables = data.readUnsigned16();
+		for (uint16_t i = 0; i < ntables && data.size() >= 6; ++i) {
+			auto sub = data;
+			sub += 2; // version
+			size_t len = sub.readUnsigned16();
+			auto coverage = sub.readUnsigned16();
+
+			// format 0, horizontal, kerning values (not minimum values)
+			if ((coverage >> 8) == 0 && (coverage & 0x0003) == 0x0001) {
+				len = std::max(len, 6 + readPairs(sub));
+			}
+
+			if (len < 6) {
+				break;
+			}
+			data += len;
+		}
+	} else if (version == 1) {
+		data += 2; // version is 1.0 in 16.16
+		auto ntables = data.readUnsigned32();
+		for (uint32_t i = 0; i < ntables && data.size() >= 8; ++i) {
+			auto sub = data;
+			size_t len = sub.readUnsigned32();
+			auto coverage = sub.readUnsigned16();
+			sub += 2; // tupleIndex
+
+			// format 0, not vertical, not cross-stream, not variation
+			if ((coverage & 0x00FF) == 0 && (coverage & 0xE000) == 0) {
+				readPairs(sub);
+			}
+
+			if (len < 8) {
+				break;
+			}
+			data += len;
+		}
+	}
+}
+
 static CharGroupId getCharGroupForChar(char32_t c) {
 	using namespace chars;
 	if (CharGroup<char32_t, CharGroupId::Numbers>::match(c)) {
@@ -457,10 +514,9 @@ CharShape FontFaceObject::getChar(char32_t c) const {
 	}
 
 	auto ch = char16_t(c & 0xFFFF);
-	std::shared_lock lock(_charsMutex);
 	auto l = _chars.get(ch);
-	if (l && l->charID == ch) {
-		return CharShape{char32_t(l->charID) | (char32_t(_plane) << 16), l->xAdvance};
+	if (l.charID == ch) {
+		return CharShape{char32_t(l.charID) | (char32_t(_plane) << 16), l.xAdvance};
 	}
 	return CharShape{0};
 }
@@ -472,40 +528,117 @@ int16_t FontFaceObject::getKerningAmount(char32_t first, char32_t second) const
 		return 0;
 	}
 
-	auto firstCh = first & 0xFFFF;
-	auto secondCh = second & 0xFFFF;
+	std::call_once(_kerningFlag, [this] { loadKerning(); });
 
-	std::shared_lock lock(_charsMutex);
-	uint32_t key = (firstCh << 16) | (secondCh & 0xffff);
-	auto it = _kerning.find(key);
-	if (it != _kerning.end()) {
-		return it->second;
+	uint32_t key = ((first & 0xFFFF) << 16) | (second & 0xFFFF);
+	auto it = std::lower_bound(_kerning.begin(), _kerning.end(), key,
+			[](const KerningPair &l, uint32_t r) { return l.key < r; });
+	if (it != _kerning.end() && it->key == key) {
+		return it->value;
 	}
 	return 0;
 }
 
-bool FontFaceObject::addChar(char16_t theChar, bool &updated) {
-	do {
-		// try to get char with shared lock
-		std::shared_lock charsLock(_charsMutex);
-		auto value = _chars.get(theChar);
-		if (value) {
-			if (value->charID == theChar) {
-				return true;
-			} else if (value->charID == char16_t(0xFFFF)) {
-				return false;
+void FontFaceObject::loadKerning() const {
+	std::unique_lock faceLock(_faceMutex);
+	if (!FT_HAS_KERNING(_face)) {
+		return;
+	}
+
+	FT_ULong length = 0;
+	auto err = FT_Load_Sfnt_Table(_face, getAxisTag("kern"), 0, nullptr, &length);
+	if (err != FT_Err_Ok || length == 0) {
+		return;
+	}
+
+	Bytes data;
+	data.resize(length);
+	err = FT_Load_Sfnt_Table(_face, getAxisTag("kern"), 0, data.data(), &length);
+	if (err != FT_Err_Ok) {
+		return;
+	}
+
+	Vector<uint32_t> glyphPairs;
+	readKernTablePairs(BytesViewNetwork(data.data(), data.size()), glyphPairs);
+	if (glyphPairs.empty()) {
+		return;
+	}
+
+	std::sort(glyphPairs.begin(), glyphPairs.end());
+	glyphPairs.erase(std::unique(glyphPairs.begin(), glyphPairs.end()), glyphPairs.end());
+
+	// (glyph << 16 | char) for chars on this plane, sorted by glyph
+	Vector<uint32_t> glyphChars;
+
+	FT_UInt gIdx = 0;
+	FT_ULong code = (_plane == 0) ? FT_Get_First_Char(_face, &gIdx)
+								  : FT_Get_Next_Char(_face, (FT_ULong(_plane) << 16) - 1, &gIdx);
+	while (gIdx != 0 && (code >> 16) == _plane) {
+		if (gIdx <= 0xFFFF) {
+			glyphChars.emplace_back(uint32_t(gIdx) << 16 | uint32_t(code & 0xFFFF));
+		}
+		code = FT_Get_Next_Char(_face, code, &gIdx);
+	}
+
+	std::sort(glyphChars.begin(), glyphChars.end());
+
+	auto getChars = [&](uint32_t glyph) {
+		auto it = std::lower_bound(glyphChars.begin(), glyphChars.end(), glyph << 16);
+		auto end = it;
+		while (end != glyphChars.end() && (*end >> 16) == glyph) { ++end; }
+		return SpanView<uint32_t>(glyphChars.data() + (it - glyphChars.begin()), end - it);
+	};
+
+	// values are scaled and rounded by FreeType, as before, but only once per pair
+	for (auto &it : glyphPairs) {
+		auto firstChars = getChars(it >> 16);
+		if (firstChars.empty()) {
+			continue;
+		}
+
+		auto secondChars = getChars(it & 0xFFFF);
+		if (secondChars.empty()) {
+			continue;
+		}
+
+		FT_Vector kerning;
+		err = FT_Get_Kerning(_face, it >> 16, it & 0xFFFF, FT_KERNING_DEFAULT, &kerning);
+		if (err != FT_Err_Ok) {
+			continue;
+		}
+
+		auto value = int16_t(kerning.x >> 6);
+		if (value == 0) {
+			continue;
+		}
+
+		for (auto &f : firstChars) {
+			for (auto &s : secondChars) {
+				_kerning.emplace_back(KerningPair{(f & 0xFFFF) << 16 | (s & 0xFFFF), value});
 			}
 		}
-	} while (0);
+	}
 
-	std::unique_lock charsUniqueLock(_charsMutex);
+	std::sort(_kerning.begin(), _kerning.end(),
+			[](const KerningPair &l, const KerningPair &r) { return l.key < r.key; });
+	_kerning.shrink_to_fit();
+}
+
+bool FontFaceObject::addChar(char16_t theChar, bool &updated) {
+	// try to get char without lock
 	auto value = _chars.get(theChar);
-	if (value) {
-		if (value->charID == theChar) {
-			return true;
-		} else if (value->charID == char16_t(0xFFFF)) {
-			return false;
-		}
+	if (value.charID == theChar) {
+		return true;
+	} else if (value.charID == char16_t(0xFFFF)) {
+		return false;
+	}
+
+	std::unique_lock charsLock(_charsMutex);
+	value = _chars.get(theChar);
+	if (value.charID == theChar) {
+		return true;
+	} else if (value.charID == char16_t(0xFFFF)) {
+		return false;
 	}
 
 	std::unique_lock faceLock(_faceMutex);
@@ -539,43 +672,6 @@ bool FontFaceObject::addChar(char16_t theChar, bool &updated) {
 		updated = true;
 	}
 
-	if (FT_HAS_KERNING(_face)) {
-		_chars.foreach ([&, this](const CharShape16 &it) {
-			if (it.charID == 0 || it.charID == char16_t(0xFFFF)) {
-				return;
-			}
-
-			if (it.charID != theChar) {
-				FT_Vector kerning;
-				auto err = FT_Get_Kerning(_face, cIdx, cIdx, FT_KERNING_DEFAULT, &kerning);
-				if (err == FT_Err_Ok) {
-					auto value = int16_t(kerning.x >> 6);
-					if (value != 0) {
-						_kerning.emplace(theChar << 16 | (it.charID & 0xffff), value);
-					}
-				}
-			} else {
-				auto kIdx = FT_Get_Char_Index(_face, it.charID);
-
-				FT_Vector kerning;
-				auto err = FT_Get_Kerning(_face, cIdx, kIdx, FT_KERNING_DEFAULT, &kerning);
-				if (err == FT_Err_Ok) {
-					auto value = int16_t(kerning.x >> 6);
-					if (value != 0) {
-						_kerning.emplace(theChar << 16 | (it.charID & 0xffff), value);
-					}
-				}
-
-				err = FT_Get_Kerning(_face, kIdx, cIdx, FT_KERNING_DEFAULT, &kerning);
-				if (err == FT_Err_Ok) {
-					auto value = int16_t(kerning.x >> 6);
-					if (value != 0) {
-						_kerning.emplace(it.charID << 16 | (theChar & 0xffff), value);
-					}
-				}
-			}
-		});
-	}
 	return true;
 }
 
@@ -595,6 +691,7 @@ bool FontFaceSet::init(String &&name, StringView family, FontSpecializationVecto
 	if (auto face = _library->openFontFace(_sources.front(), _spec)) {
 		_faces[0] = face;
 		_metrics = _faces.front()->getMetrics();
+		_loadedFaces.store(1, std::memory_order_release);
 	}
 	return true;
 }
@@ -610,6 +707,7 @@ bool FontFaceSet::init(String &&name, StringView family, FontSpecializationVecto
 	if (auto face = _library->openFontFace(_sources.front(), _spec)) {
 		_faces[0] = face;
 		_metrics = _faces.front()->getMetrics();
+		_loadedFaces.store(1, std::memory_order_release);
 	}
 	return true;
 }
@@ -665,6 +763,9 @@ bool FontFaceSet::addString(const CharVector &str, Vector<char32_t> &failed) {
 		for (; i < _faces.size(); ++i) {
 			if (_faces[i] == nullptr) {
 				_faces[i] = _library->openFontFace(_sources[i], _spec);
+				if (_faces[i]) {
+					_loadedFaces.store(i + 1, std::memory_order_release);
+				}
 			}
 
 			auto tmp = sp::move(failed);
@@ -686,14 +787,10 @@ bool FontFaceSet::addString(const CharVector &str, Vector<char32_t> &failed) {
 uint16_t FontFaceSet::getFontHeight() const { return _metrics.height; }
 
 int16_t FontFaceSet::getKerningAmount(char32_t first, char32_t second, uint16_t face) const {
-	std::shared_lock lock(_mutex);
-	for (auto &it : _faces) {
-		if (it) {
-			if (it->getId() == face) {
-				return it->getKerningAmount(first, second);
-			}
-		} else {
-			return 0;
+	auto count = _loadedFaces.load(std::memory_order_acquire);
+	for (size_t i = 0; i < count; ++i) {
+		if (_faces[i]->getId() == face) {
+			return _faces[i]->getKerningAmount(first, second);
 		}
 	}
 	return 0;
@@ -702,11 +799,12 @@ int16_t FontFaceSet::getKerningAmount(char32_t first, char32_t second, uint16_t
 Metrics FontFaceSet::getMetrics() const { return _metrics; }
 
 CharShape FontFaceSet::getChar(char32_t ch, uint16_t &face) const {
-	std::shared_lock lock(_mutex);
-	for (auto &it : _faces) {
-		auto l = it->getChar(ch);
+	// faces are opened in order and never replaced, so loaded prefix can be read without lock
+	auto count = _loadedFaces.load(std::memory_order_acquire);
+	for (size_t i = 0; i < count; ++i) {
+		auto l = _faces[i]->getChar(ch);
 		if (l.charID != 0) {
-			face = it->getId();
+			face = _faces[i]->getId();
 			return l;
 		}
 	}
@@ -99,8 +99,16 @@ public:
 	Metrics getMetrics() const { return _metrics; }
 
 protected:
+	struct KerningPair {
+		uint32_t key; // first << 16 | second, chars on face's plane
+		int16_t value;
+	};
+
 	bool addChar(char16_t, bool &updated);
 
+	// Loads kerning pairs for all chars of the plane on first request
+	void loadKerning() const;
+
 	Interface::StringType _name;
 	Rc<FontFaceData> _data;
 	uint16_t _id = 0;
@@ -110,9 +118,10 @@ protected:
 	Metrics _metrics;
 	Interface::VectorType<char32_t> _required;
 	FontCharStorage<CharShape16> _chars;
-	mem_std::HashMap<uint32_t, int16_t> _kerning;
-	mem_std::Mutex _faceMutex;
-	mutable std::shared_mutex _charsMutex;
+	mutable std::once_flag _kerningFlag;
+	mutable Interface::VectorType<KerningPair> _kerning; // sorted by key, immutable when loaded
+	mutable mem_std::Mutex _faceMutex;
+	mutable mem_std::Mutex _charsMutex; // serializes writers, readers are lock-free
 	mutable mem_std::Mutex _requiredMutex;
 };
 
@@ -167,6 +176,7 @@ protected:
 	FontSpecializationVector _spec;
 	Vector<Rc<FontFaceData>> _sources;
 	Vector<Rc<FontFaceObject>> _faces;
+	std::atomic<size_t> _loadedFaces = 0; // number of opened faces at the start of _faces
 	FontLibrary *_library = nullptr;
 
 	mutable size_t _texturesCount = 0;
@@ -610,9 +610,21 @@ static Cam16Float InverseChromaticAdaptation(Cam16Float adapted) {
 	return Cam16::signum(adapted) * std::pow(base, Cam16Float(1.0 / 0.42));
 }
 
-static Color4F FindResultByJ(Cam16Float hue_radians, Cam16Float chroma, Cam16Float y) {
-	// Initial estimate of j.
-	Cam16Float j = std::sqrt(y) * 11.0;
+// Hue-dependent values for FindResultByJ, same for all tones of a palette
+struct Cam16HueData {
+	Cam16Float hue_degrees;
+	Cam16Float hue_radians;
+	Cam16Float t_inner_coeff;
+	Cam16Float p1;
+	Cam16Float h_sin;
+	Cam16Float h_cos;
+};
+
+static Cam16HueData Cam16_makeHueData(Cam16Float hue_degrees) {
+	hue_degrees = Cam16::sanitizeDegrees(hue_degrees);
+
+	const Cam16Float hue_radians = hue_degrees / 180 * numbers::pi;
+
 	// ===========================================================
 	// Operations inlined from Cam16 to avoid repeated calculation
 	// ===========================================================
@@ -624,8 +636,19 @@ static Color4F FindResultByJ(Cam16Float hue_radians, Cam16Float chroma, Cam16Flo
 	const Cam16Float e_hue = 0.25 * (std::cos(hue_radians + Cam16Float(2.0)) + 3.8);
 	const Cam16Float p1 = e_hue * (50000.0 / 13.0) * ViewingConditions::DEFAULT.n_c
 			* ViewingConditions::DEFAULT.ncb;
-	const Cam16Float h_sin = std::sin(hue_radians);
-	const Cam16Float h_cos = std::cos(hue_radians);
+
+	return Cam16HueData{hue_degrees, hue_radians, t_inner_coeff, p1, std::sin(hue_radians),
+		std::cos(hue_radians)};
+}
+
+static Color4F FindResultByJ(const Cam16HueData &hue, Cam16Float chroma, Cam16Float y) {
+	// Initial estimate of j.
+	Cam16Float j = std::sqrt(y) * 11.0;
+
+	const Cam16Float t_inner_coeff = hue.t_inner_coeff;
+	const Cam16Float p1 = hue.p1;
+	const Cam16Float h_sin = hue.h_sin;
+	const Cam16Float h_cos = hue.h_cos;
 	for (int iteration_round = 0; iteration_round < 5; ++iteration_round) {
 		// ===========================================================
 		// Operations inlined from Cam16 to avoid repeated calculation
@@ -706,25 +729,222 @@ static void fixTone(Cam16Float &h, Cam16Float &c, Cam16Float &t, Color4F &color)
 	}
 }
 
-static Color4F SolveToColor4F(Cam16Float hue_degrees, Cam16Float chroma, Cam16Float lstar) {
+static Color4F SolveToColor4F(const Cam16HueData &hue, Cam16Float chroma, Cam16Float lstar) {
 	if (chroma < 0.0001 || lstar < 0.0001 || lstar > 99.9999) {
 		return Color4FFromLstar(lstar);
 	}
 
-	hue_degrees = Cam16::sanitizeDegrees(hue_degrees);
 	//fixTone(hue_degrees, chroma, lstar);
-	Cam16Float hue_radians = hue_degrees / 180 * numbers::pi;
 	Cam16Float y = ViewingConditions::YFromLstar(lstar);
-	Color4F exact_answer = FindResultByJ(hue_radians, chroma, y);
+	Color4F exact_answer = FindResultByJ(hue, chroma, y);
 	if (exact_answer != Color4F::BLACK) {
 		return exact_answer;
 	}
-	Cam16Vec3 linrgb = BisectToLimit(y, hue_radians);
+	Cam16Vec3 linrgb = BisectToLimit(y, hue.hue_radians);
 	auto ret = Color4FFromLinrgb(linrgb);
+	auto hue_degrees = hue.hue_degrees;
 	fixTone(hue_degrees, chroma, lstar, ret);
 	return ret;
 }
 
+static Color4F SolveToColor4F(Cam16Float hue_degrees, Cam16Float chroma, Cam16Float lstar) {
+	if (chroma < 0.0001 || lstar < 0.0001 || lstar > 99.9999) {
+		return Color4FFromLstar(lstar);
+	}
+
+	return SolveToColor4F(Cam16_makeHueData(hue_degrees), chroma, lstar);
+}
+
+// Batch conversion: linear stages are computed for four colors at once (structure of arrays),
+// transcendental functions are evaluated per color
+
+static constexpr uint32_t Cam16LinearizedTableSize = 1024;
+
+struct Cam16BatchConditions {
+	const ViewingConditions *vc;
+
+	// linear sRGB -> XYZ -> cone responses -> illuminant discount, as single matrix
+	alignas(16) Cam16Float discount[3][3];
+
+	// pow(1.64 - pow(0.29, n), 0.73)
+	Cam16Float alpha_coeff;
+
+	// 50000 / 13 * n_c * ncb
+	Cam16Float p1_coeff;
+};
+
+static Cam16BatchConditions Cam16_makeBatchConditions(const ViewingConditions &vc) {
+	constexpr Cam16Float xyzFromLinrgb[3][3] = {
+		{0.41233895, 0.35762064, 0.18051042},
+		{0.2126, 0.7152, 0.0722},
+		{0.01932141, 0.11916382, 0.95034478},
+	};
+
+	constexpr Cam16Float coneFromXyz[3][3] = {
+		{0.401288, 0.650173, -0.051461},
+		{-0.250268, 1.204414, 0.045854},
+		{-0.002079, 0.048952, 0.953127},
+	};
+
+	Cam16BatchConditions ret;
+	ret.vc = &vc;
+
+	for (size_t i = 0; i < 3; ++i) {
+		for (size_t j = 0; j < 3; ++j) {
+			Cam16Float value = 0.0;
+			for (size_t k = 0; k < 3; ++k) { value += coneFromXyz[i][k] * xyzFromLinrgb[k][j]; }
+			ret.discount[i][j] = vc.rgb_d[i] * value;
+		}
+	}
+
+	ret.alpha_coeff = std::pow(Cam16Float(1.64)
+					- std::pow(Cam16Float(0.29), vc.background_y_to_white_point_y),
+			Cam16Float(0.73));
+	ret.p1_coeff = 50000.0 / 13.0 * vc.n_c * vc.ncb;
+	return ret;
+}
+
+static const Cam16Float *Cam16_getLinearizedTable() {
+	// extra point at the end allows to interpolate 1.0 without branch
+	static const auto s_table = [] {
+		std::array<Cam16Float, Cam16LinearizedTableSize + 2> ret;
+		for (uint32_t i = 0; i <= Cam16LinearizedTableSize; ++i) {
+			ret[i] = Cam16::linearized(Cam16Float(i) / Cam16LinearizedTableSize);
+		}
+		ret[Cam16LinearizedTableSize + 1] = ret[Cam16LinearizedTableSize];
+		return ret;
+	}();
+	return s_table.data();
+}
+
+static inline Cam16Float Cam16_linearizedFast(const Cam16Float *table, Cam16Float value) {
+	value = std::clamp(value, Cam16Float(0.0), Cam16Float(1.0)) * Cam16LinearizedTableSize;
+	const auto idx = uint32_t(value);
+	const auto frac = value - Cam16Float(idx);
+	return table[idx] + (table[idx + 1] - table[idx]) * frac;
+}
+
+static inline Cam16Float Cam16_adapted(Cam16Float fl, Cam16Float value) {
+	const Cam16Float af = std::pow(Cam16Float(fl * std::fabs(value) / 100.0), Cam16Float(0.42));
+	return Cam16::signum(value) * 400.0 * af / (af + 27.13);
+}
+
+// Computes Cam16 and relative luminance Y for each color
+template <typename Callback>
+static void Cam16_createBatch(const Color4F *colors, size_t count, const ViewingConditions &vc,
+		bool fast, const Callback &cb) {
+	const auto cond = Cam16_makeBatchConditions(vc);
+	const Cam16Float *table = fast ? Cam16_getLinearizedTable() : nullptr;
+
+	simd::f32x4 discount[3][3];
+	for (size_t i = 0; i < 3; ++i) {
+		for (size_t j = 0; j < 3; ++j) { discount[i][j] = simd::load(cond.discount[i][j]); }
+	}
+
+	const simd::f32x4 yFromLinrgb[3] = {simd::load(kYFromLinrgb[0]),
+		simd::load(kYFromLinrgb[1]), simd::load(kYFromLinrgb[2])};
+
+	auto dot3 = [](const simd::f32x4 m[3], const simd::f32x4 &r, const simd::f32x4 &g,
+						const simd::f32x4 &b) {
+		return simd::add(simd::add(simd::mul(m[0], r), simd::mul(m[1], g)), simd::mul(m[2], b));
+	};
+
+	alignas(16) Cam16Float lin[3][4];
+	alignas(16) Cam16Float disc[3][4];
+	alignas(16) Cam16Float adapted[3][4];
+	alignas(16) Cam16Float opp[4][4]; // a, b, u, p2
+	alignas(16) Cam16Float lum[4];
+
+	const simd::f32x4 oppCoeffs[4][3] = {
+		{simd::load(1.0f), simd::load(-12.0f / 11.0f), simd::load(1.0f / 11.0f)},
+		{simd::load(1.0f / 9.0f), simd::load(1.0f / 9.0f), simd::load(-2.0f / 9.0f)},
+		{simd::load(1.0f), simd::load(1.0f), simd::load(21.0f / 20.0f)},
+		{simd::load(2.0f), simd::load(1.0f), simd::load(1.0f / 20.0f)},
+	};
+
+	for (size_t offset = 0; offset < count; offset += 4) {
+		const size_t nlanes = std::min(count - offset, size_t(4));
+
+		for (size_t i = 0; i < 4; ++i) {
+			if (i < nlanes) {
+				auto &c = colors[offset + i];
+				if (table) {
+					lin[0][i] = Cam16_linearizedFast(table, c.r);
+					lin[1][i] = Cam16_linearizedFast(table, c.g);
+					lin[2][i] = Cam16_linearizedFast(table, c.b);
+				} else {
+					lin[0][i] = Cam16::linearized(c.r);
+					lin[1][i] = Cam16::linearized(c.g);
+					lin[2][i] = Cam16::linearized(c.b);
+				}
+			} else {
+				lin[0][i] = lin[1][i] = lin[2][i] = 0.0;
+			}
+		}
+
+		const auto r = simd::load(lin[0]);
+		const auto g = simd::load(lin[1]);
+		const auto b = simd::load(lin[2]);
+
+		simd::store(disc[0], dot3(discount[0], r, g, b));
+		simd::store(disc[1], dot3(discount[1], r, g, b));
+		simd::store(disc[2], dot3(discount[2], r, g, b));
+		simd::store(lum, dot3(yFromLinrgb, r, g, b));
+
+		// Chromatic adaptation.
+		for (size_t i = 0; i < 4; ++i) {
+			adapted[0][i] = Cam16_adapted(vc.fl, disc[0][i]);
+			adapted[1][i] = Cam16_adapted(vc.fl, disc[1][i]);
+			adapted[2][i] = Cam16_adapted(vc.fl, disc[2][i]);
+		}
+
+		const auto r_a = simd::load(adapted[0]);
+		const auto g_a = simd::load(adapted[1]);
+		const auto b_a = simd::load(adapted[2]);
+
+		// Redness-greenness
+		for (size_t i = 0; i < 4; ++i) { simd::store(opp[i], dot3(oppCoeffs[i], r_a, g_a, b_a)); }
+
+		for (size_t i = 0; i < nlanes; ++i) {
+			const Cam16Float a = opp[0][i];
+			const Cam16Float b = opp[1][i];
+			const Cam16Float u = opp[2][i];
+			const Cam16Float p2 = opp[3][i];
+
+			const Cam16Float radians = std::atan2(b, a);
+			const Cam16Float degrees = radians * 180.0 / numbers::pi;
+			const Cam16Float _hue = Cam16::sanitizeDegrees(degrees);
+			const Cam16Float hue_radians = _hue * numbers::pi / 180.0;
+			const Cam16Float ac = p2 * vc.nbb;
+
+			const Cam16Float _j = 100.0 * std::pow(ac / vc.aw, vc.c * vc.z);
+			const Cam16Float _q = (4.0 / vc.c) * std::sqrt(Cam16Float(_j / 100.0)) * (vc.aw + 4.0)
+					* vc.fl_root;
+			const Cam16Float hue_prime = _hue < 20.14 ? _hue + 360 : _hue;
+			const Cam16Float e_hue =
+					0.25 * (std::cos(Cam16Float(hue_prime * numbers::pi / 180.0 + 2.0)) + 3.8);
+			const Cam16Float p1 = e_hue * cond.p1_coeff;
+			const Cam16Float t = p1 * std::sqrt(a * a + b * b) / (u + Cam16Float(0.305));
+			const Cam16Float alpha = std::pow(t, Cam16Float(0.9)) * cond.alpha_coeff;
+			const Cam16Float c = alpha * std::sqrt(_j / Cam16Float(100.0));
+			const Cam16Float _m = c * vc.fl_root;
+			const Cam16Float _s = 50.0 * sqrt((alpha * vc.c) / (vc.aw + 4.0));
+			const Cam16Float _jstar = (1.0 + 100.0 * 0.007) * _j / (1.0 + 0.007 * _j);
+			const Cam16Float mstar = 1.0 / 0.0228 * std::log(Cam16Float(1.0 + 0.0228 * _m));
+			const Cam16Float _astar = mstar * std::cos(hue_radians);
+			const Cam16Float _bstar = mstar * std::sin(hue_radians);
+
+			cb(offset + i, Cam16{_hue, c, _j, _q, _m, _s, _jstar, _astar, _bstar}, lum[i]);
+		}
+	}
+}
+
+void Cam16::create(const Color4F *colors, Cam16 *out, size_t count,
+		const ViewingConditions &vc, bool fast) {
+	Cam16_createBatch(colors, count, vc, fast,
+			[&](size_t idx, const Cam16 &cam, Cam16Float) { out[idx] = cam; });
+}
+
 ColorHCT ColorHCT::progress(const ColorHCT &a, const ColorHCT &b, float p) {
 	return ColorHCT((a.data.hue * (1.0f - p) + b.data.hue * p),
 			(a.data.chroma * (1.0f - p) + b.data.chroma * p),
@@ -744,6 +964,33 @@ Color4F ColorHCT::solveColor4F(Cam16Float h, Cam16Float c, Cam16Float t, float a
 	return tmp;
 }
 
+void ColorHCT::create(const Color4F *colors, ColorHCT *out, size_t count, bool fast) {
+	Cam16_createBatch(colors, count, ViewingConditions::DEFAULT, fast,
+			[&](size_t idx, const Cam16 &cam, Cam16Float y) {
+		auto &target = out[idx];
+		target.data.hue = cam.hue;
+		target.data.chroma = cam.chroma;
+		target.data.tone = Cam16::LstarFromY(y);
+		target.data.alpha = colors[idx].a;
+		target.color = colors[idx];
+	});
+}
+
+void ColorHCT::solveColor4F(const Values *values, Color4F *out, size_t count) {
+	for (size_t i = 0; i < count; ++i) {
+		out[i] = solveColor4F(values[i].hue, values[i].chroma, values[i].tone, values[i].alpha);
+	}
+}
+
+void ColorHCT::solveColor4F(Cam16Float h, Cam16Float c, const Cam16Float *tones, Color4F *out,
+		size_t count, float a) {
+	const auto hue = Cam16_makeHueData(h);
+	for (size_t i = 0; i < count; ++i) {
+		out[i] = SolveToColor4F(hue, c, tones[i]);
+		out[i].a = a;
+	}
+}
+
 std::ostream &operator<<(std::ostream &stream, const ColorHCT &obj) {
 	stream << "ColorHCT(h:" << obj.data.hue << " c:" << obj.data.chroma << " t:" << obj.data.tone
 		   << " a:" << obj.data.alpha << ");";
@@ -321,6 +321,17 @@ struct SP_PUBLIC Cam16 {
 		return Cam16{_hue, c, _j, _q, _m, _s, _jstar, _astar, _bstar};
 	}
 
+	// Batch version of create for arrays of colors, viewing conditions are prepared once per call
+	// Linear stages (linear sRGB -> XYZ -> discounted cone responses, opponent components)
+	// are computed for four colors at once with simd::, transcendental functions are scalar
+	//
+	// With `fast`, sRGB linearization uses 1024-segment lookup table with linear interpolation
+	// (components are clamped to [0.0, 1.0]); linearized value error is below 0.0001 (of 100.0),
+	// resulting chroma and j error is below 0.001, hue error is below 0.05 degree for colors
+	// with chroma above 1.0 (hue of near-gray colors is unstable anyway)
+	static void create(const Color4F *, Cam16 *, size_t count,
+			const ViewingConditions & = ViewingConditions::DEFAULT, bool fast = false);
+
 	Float hue = 0.0;
 	Float chroma = 0.0;
 	Float j = 0.0;
@@ -46,6 +46,14 @@ struct alignas(16) ColorHCT {
 	static ColorHCT solveColorHCT(Cam16Float h, Cam16Float c, Cam16Float t, float a);
 	static Color4F solveColor4F(Cam16Float h, Cam16Float c, Cam16Float t, float a);
 
+	// Batch versions, see Cam16::create for `fast` mode error bounds
+	static void create(const Color4F *, ColorHCT *, size_t count, bool fast = false);
+	static void solveColor4F(const Values *, Color4F *, size_t count);
+
+	// Solves colors for a tonal palette: hue-dependent values are computed once for all tones
+	static void solveColor4F(Cam16Float h, Cam16Float c, const Cam16Float *tones, Color4F *,
+			size_t count, float a = 1.0f);
+
 	constexpr ColorHCT() : data({0.0f, 50.0f, 0.0f, 1.0f}), color(Color4F::BLACK) { }
 
 	ColorHCT(float h, float c, float t, float a)
@@ -246,6 +246,18 @@ public:
 		transformVector(point->x, point->y, 1.0f, 1.0f, &ret);
 		*point = Vec2(ret.x, ret.y);
 	}
+
+	// Batch versions of transformPoint, src and dst can be the same
+	// Not bit-exact with transformPoint (different operation order, no FMA), so do not
+	// mix them for points, that should match exactly
+	void transformPoints(const Vec2 *src, Vec2 *dst, size_t count) const {
+		simd::transformVec2Batch(m, &src->x, &dst->x, count, true);
+	}
+	// Same, but without translation (for normals and other directions)
+	void transformDirections(const Vec2 *src, Vec2 *dst, size_t count) const {
+		simd::transformVec2Batch(m, &src->x, &dst->x, count, false);
+	}
+
 	void transformVector(Vec4 *vector) const { simd::transformVec4(m, &vector->x, &vector->x); }
 	void transformVector(float x, float y, float z, float w, Vec4 *dst) const {
 		simd::transformVec4Components(m, x, y, z, w, &dst->x);
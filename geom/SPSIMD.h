@@ -226,6 +226,10 @@ SP_ATTR_OPTIMIZE_INLINE_FN inline void crossVec3(const float v1[3], const float
 	SP_GEOM_DEFAULT_SIMD_NAMESPACE::crossVec3(v1, v2, dst);
 }
 
+SP_ATTR_OPTIMIZE_INLINE_FN inline void transformVec2Batch(const float m[16], const float *src, float *dst, size_t count, bool translate = true) {
+	SP_GEOM_DEFAULT_SIMD_NAMESPACE::transformVec2Batch(m, src, dst, count, translate);
+}
+
 // input for test A->B vs C->D (ax, ay, bx, by), (cx, cy, dx, dy)
 SP_ATTR_OPTIMIZE_INLINE_FN inline bool isVec2BboxIntersects(const f32x4 & v1, const f32x4 & v2, f32x4 &isect) {
 	return SP_GEOM_DEFAULT_SIMD_NAMESPACE::isVec2BboxIntersects(v1, v2, isect);
@@ -395,6 +395,39 @@ inline void crossVec3(const float v1[3], const float v2[3], float dst[3]) {
 
 #endif
 
+// Transforms `count` 2D points (pairs of x, y) with matrix, like Mat4::transformPoint (z = 1, w = 1),
+// or as directions without translation (z = 0, w = 0); src and dst can be the same buffer
+// Results can differ from Mat4::transformPoint in the last bits: translation is summed
+// before multiplication, and products are not fused
+SP_ATTR_OPTIMIZE_INLINE_FN inline void transformVec2Batch(const float m[16], const float *src, float *dst, size_t count, bool translate) {
+	const float tx = translate ? m[8] + m[12] : 0.0f;
+	const float ty = translate ? m[9] + m[13] : 0.0f;
+
+	const simde_float32x4_t txv = simde_vdupq_n_f32(tx);
+	const simde_float32x4_t tyv = simde_vdupq_n_f32(ty);
+
+	size_t i = 0;
+	for (; i + 4 <= count; i += 4) {
+		// deinterleave 4 points into (x0, x1, x2, x3), (y0, y1, y2, y3)
+		simde_float32x4x2_t v = simde_vld2q_f32(src + i * 2);
+		simde_float32x4x2_t r;
+
+		r.val[0] = simde_vaddq_f32(simde_vaddq_f32(
+				simde_vmulq_n_f32(v.val[0], m[0]), simde_vmulq_n_f32(v.val[1], m[4])), txv);
+		r.val[1] = simde_vaddq_f32(simde_vaddq_f32(
+				simde_vmulq_n_f32(v.val[0], m[1]), simde_vmulq_n_f32(v.val[1], m[5])), tyv);
+
+		simde_vst2q_f32(dst + i * 2, r);
+	}
+
+	for (; i < count; ++ i) {
+		const float x = src[i * 2];
+		const float y = src[i * 2 + 1];
+		dst[i * 2] = (m[0] * x + m[4] * y) + tx;
+		dst[i * 2 + 1] = (m[1] * x + m[5] * y) + ty;
+	}
+}
+
 // input for test A->B vs C->D (ax, ay, bx, by), (cx, cy, dx, dy)
 SP_ATTR_OPTIMIZE_INLINE_FN inline bool isVec2BboxIntersects(const f32x4 & v1, const f32x4 & v2, f32x4 &isect) {
 	struct alignas(16) data_t {
@@ -408,6 +408,38 @@ SP_ATTR_OPTIMIZE_INLINE_FN inline void crossVec3(const float v1[3], const float
 	dst[2] = z;
 }
 
+// Transforms `count` 2D points (pairs of x, y) with matrix, like Mat4::transformPoint (z = 1, w = 1),
+// or as directions without translation (z = 0, w = 0); src and dst can be the same buffer
+// Results can differ from Mat4::transformPoint in the last bits: translation is summed
+// before multiplication, and products are not fused
+SP_ATTR_OPTIMIZE_INLINE_FN inline void transformVec2Batch(const float m[16], const float *src, float *dst, size_t count, bool translate) {
+	const float tx = translate ? m[8] + m[12] : 0.0f;
+	const float ty = translate ? m[9] + m[13] : 0.0f;
+
+	const simde__m128 col1 = simde_mm_set_ps(m[1], m[0], m[1], m[0]);
+	const simde__m128 col2 = simde_mm_set_ps(m[5], m[4], m[5], m[4]);
+	const simde__m128 offset = simde_mm_set_ps(ty, tx, ty, tx);
+
+	size_t i = 0;
+	for (; i + 2 <= count; i += 2) {
+		simde__m128 v = simde_mm_loadu_ps(src + i * 2); // x0, y0, x1, y1
+
+		simde__m128 xv = simde_mm_shuffle_ps(v, v, SIMDE_MM_SHUFFLE(2, 2, 0, 0)); // x0, x0, x1, x1
+		simde__m128 yv = simde_mm_shuffle_ps(v, v, SIMDE_MM_SHUFFLE(3, 3, 1, 1)); // y0, y0, y1, y1
+
+		simde_mm_storeu_ps(dst + i * 2, simde_mm_add_ps(
+				simde_mm_add_ps(simde_mm_mul_ps(col1, xv), simde_mm_mul_ps(col2, yv)),
+				offset));
+	}
+
+	if (i < count) {
+		const float x = src[i * 2];
+		const float y = src[i * 2 + 1];
+		dst[i * 2] = (m[0] * x + m[4] * y) + tx;
+		dst[i * 2 + 1] = (m[1] * x + m[5] * y) + ty;
+	}
+}
+
 // input for test A->B vs C->D (ax, ay, bx, by), (cx, cy, dx, dy)
 SP_ATTR_OPTIMIZE_INLINE_FN inline bool isVec2BboxIntersects(const f32x4 & v1, const f32x4 & v2, f32x4 &isect) {
 	struct alignas(16) data_t {
@@ -162,6 +162,159 @@ SPUNUSED static void CurlHandle_releaseHandle(CURL *curl, bool reuse, bool succe
 
 uint32_t getActiveHandles() { return CurlHandle::getActiveHandles(); }
 
+// Process-wide CURLSH, shared between all handles with `shareCache` flag
+// Share object is never released: easy handles, cached in pools and threads, can outlive
+// static destructors, and curl requires share to outlive all its handles
+struct ShareCache {
+	static ShareCache *getInstance() {
+		static ShareCache *s_instance = new ShareCache();
+		return s_instance;
+	}
+
+	bool setConfig(const ShareCacheConfig &cfg) {
+		std::unique_lock lock(_mutex);
+		if (_share) {
+			log::source().error("CURL", "Share cache is already in use and can not be reconfigured");
+			return false;
+		}
+		_config = cfg;
+		return true;
+	}
+
+	ShareCacheConfig getConfig() {
+		std::unique_lock lock(_mutex);
+		return _config;
+	}
+
+	ShareCacheStats getStats() const {
+		ShareCacheStats ret;
+		ret.transfers = _transfers.load();
+		ret.reusedConnections = _reusedConnections.load();
+		ret.newConnections = _newConnections.load();
+		ret.lockContentions = _lockContentions.load();
+		return ret;
+	}
+
+	CURLSH *get() {
+		if (auto s = _active.load(std::memory_order_acquire)) {
+			return s;
+		}
+
+		std::unique_lock lock(_mutex);
+		if (!_share) {
+			_share = curl_share_init();
+			if (!_share) {
+				return nullptr;
+			}
+
+			curl_share_setopt(_share, CURLSHOPT_LOCKFUNC, &onLock);
+			curl_share_setopt(_share, CURLSHOPT_UNLOCKFUNC, &onUnlock);
+			curl_share_setopt(_share, CURLSHOPT_USERDATA, this);
+
+			if (_config.cookies) {
+				curl_share_setopt(_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_COOKIE);
+			}
+			if (_config.dns) {
+				curl_share_setopt(_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+			}
+			if (_config.sslSessions) {
+				curl_share_setopt(_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+			}
+			if (_config.connections) {
+				curl_share_setopt(_share, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+			}
+			_active.store(_share, std::memory_order_release);
+		}
+		return _share;
+	}
+
+	bool isCookiesShared() const { return _config.cookies; }
+
+	void setup(CURL *curl) {
+		if (_config.maxConnections) {
+			curl_easy_setopt(curl, CURLOPT_MAXCONNECTS, long(_config.maxConnections));
+		}
+	}
+
+	void setup(CURLM *multi) {
+		std::unique_lock lock(_mutex);
+		if (_config.maxConnections) {
+			curl_multi_setopt(multi, CURLMOPT_MAXCONNECTS, long(_config.maxConnections));
+		}
+		if (_config.maxHostConnections) {
+			curl_multi_setopt(multi, CURLMOPT_MAX_HOST_CONNECTIONS,
+					long(_config.maxHostConnections));
+		}
+	}
+
+	void onTransferComplete(CURL *curl, bool success) {
+		++_transfers;
+		if (!success) {
+			// failed lookup or refused connection also reports zero new connections
+			return;
+		}
+
+		long connects = 0;
+		if (curl_easy_getinfo(curl, CURLINFO_NUM_CONNECTS, &connects) == CURLE_OK) {
+			if (connects == 0) {
+				++_reusedConnections;
+			} else {
+				_newConnections += connects;
+			}
+		}
+	}
+
+protected:
+	static void onLock(CURL *, curl_lock_data data, curl_lock_access, void *ptr) {
+		auto cache = static_cast<ShareCache *>(ptr);
+		auto &m = cache->_locks[size_t(data) % size_t(CURL_LOCK_DATA_LAST)];
+		if (!m.try_lock()) {
+			++cache->_lockContentions;
+			m.lock();
+		}
+	}
+
+	static void onUnlock(CURL *, curl_lock_data data, void *ptr) {
+		auto cache = static_cast<ShareCache *>(ptr);
+		cache->_locks[size_t(data) % size_t(CURL_LOCK_DATA_LAST)].unlock();
+	}
+
+	std::mutex _mutex;
+	ShareCacheConfig _config;
+	CURLSH *_share = nullptr;
+	std::atomic<CURLSH *> _active = nullptr;
+	std::array<std::mutex, CURL_LOCK_DATA_LAST> _locks;
+
+	std::atomic<uint64_t> _transfers = 0;
+	std::atomic<uint64_t> _reusedConnections = 0;
+	std::atomic<uint64_t> _newConnections = 0;
+	std::atomic<uint64_t> _lockContentions = 0;
+};
+
+SPUNUSED static CURLSH *ShareCache_get() { return ShareCache::getInstance()->get(); }
+
+SPUNUSED static bool ShareCache_isCookiesShared() {
+	return ShareCache::getInstance()->isCookiesShared();
+}
+
+SPUNUSED static void ShareCache_setup(CURL *curl) { ShareCache::getInstance()->setup(curl); }
+
+SPUNUSED static void ShareCache_setupMulti(CURLM *multi) {
+	ShareCache::getInstance()->setup(multi);
+}
+
+SPUNUSED static void ShareCache_onTransferComplete(CURL *curl, bool success) {
+	ShareCache::getInstance()->onTransferComplete(curl, success);
+}
+
+bool setShareCacheConfig(const ShareCacheConfig &cfg) {
+	return ShareCache::getInstance()->setConfig(cfg);
+}
+
+ShareCacheConfig getShareCacheConfig() { return ShareCache::getInstance()->getConfig(); }
+
+ShareCacheStats getShareCacheStats() { return ShareCache::getInstance()->getStats(); }
+
 } // namespace stappler::network
 
 #include "SPNetworkCABundle.cc"
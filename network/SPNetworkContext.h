@@ -67,6 +67,7 @@ struct SP_PUBLIC Context {
 
 	int code = 0;
 	bool success = false;
+	bool shareCache = false;
 	std::array<char, 256> error = { 0 };
 };
 
@@ -366,6 +366,7 @@ HANDLE_NAME_CONST(const Vector<String> &, getRecievedHeaders) { return receive.h
 HANDLE_NAME(void, setDebug, bool value) { process.debug = value; }
 HANDLE_NAME(void, setReuse, bool value) { process.reuse = value; }
 HANDLE_NAME(void, setShared, bool value) { process.shared = value; }
+HANDLE_NAME(void, setShareCache, bool value) { process.shareCache = value; }
 HANDLE_NAME(void, setSilent, bool value) { process.silent = value; }
 HANDLE_NAME_CONST(const StringStream &, getDebugData) { return process.debugData; }
 
@@ -473,6 +474,7 @@ HANDLE_NAME_CONST(const Vector<String> &, getRecievedHeaders) { return receive.h
 HANDLE_NAME(void, setDebug, bool value) { process.debug = value; }
 HANDLE_NAME(void, setReuse, bool value) { process.reuse = value; }
 HANDLE_NAME(void, setShared, bool value) { process.shared = value; }
+HANDLE_NAME(void, setShareCache, bool value) { process.shareCache = value; }
 HANDLE_NAME(void, setSilent, bool value) { process.silent = value; }
 HANDLE_NAME_CONST(const StringStream &, getDebugData) { return process.debugData; }
 
@@ -55,6 +55,37 @@ enum class AuthMethod {
 
 uint32_t getActiveHandles();
 
+// Options for process-wide share cache, that handles join by default (see HandleData::setShareCache)
+struct SP_PUBLIC ShareCacheConfig {
+	bool connections = true;
+	bool dns = true;
+	bool sslSessions = true;
+
+	// cookies are shared between all handles in process when enabled,
+	// so it's disabled by default; use setShared or setCookieFile for per-handle cookies
+	bool cookies = false;
+
+	// connection cache size for single handle (CURLOPT_MAXCONNECTS), 0 for libcurl default
+	uint32_t maxConnections = 0;
+
+	// connections limit per host for MultiHandle (CURLMOPT_MAX_HOST_CONNECTIONS), 0 for unlimited
+	uint32_t maxHostConnections = 0;
+};
+
+// Connections are counted only for successful transfers; libcurl does not report hits of shared
+// DNS and TLS session caches, so there are no counters for them
+struct SP_PUBLIC ShareCacheStats {
+	uint64_t transfers = 0; // transfers, performed with share cache (including failed ones)
+	uint64_t reusedConnections = 0; // successful transfers, that reused cached connection
+	uint64_t newConnections = 0; // connections, opened by successful transfers
+	uint64_t lockContentions = 0; // share locks, that was acquired with waiting
+};
+
+// Share cache can be configured only before first transfer that uses it
+SP_PUBLIC bool setShareCacheConfig(const ShareCacheConfig &);
+SP_PUBLIC ShareCacheConfig getShareCacheConfig();
+SP_PUBLIC ShareCacheStats getShareCacheStats();
+
 template <typename Interface>
 struct SP_PUBLIC AuthData {
 	using String = typename Interface::StringType;
@@ -134,6 +165,7 @@ struct SP_PUBLIC ProcessData {
 	int lowSpeedLimit = 10_KiB;
 
 	bool shared = false;
+	bool shareCache = true;
 	bool verifyTsl = true;
 	bool debug = false;
 	bool reuse = true;
@@ -260,6 +292,7 @@ struct SP_PUBLIC HandleData : Interface::AllocBaseType {
 	void setDebug(bool value);
 	void setReuse(bool value);
 	void setShared(bool value);
+	void setShareCache(bool value);
 	void setSilent(bool value);
 	const StringStream &getDebugData() const;
 
@@ -35,12 +35,19 @@ THE SOFTWARE.
 #include "SPBitmap.h"
 #endif
 
+#if MODULE_STAPPLER_EVENT
+#include "SPEventLooper.h"
+#include "SPEventPollHandle.h"
+#include "SPEventTimerHandle.h"
+#endif
+
 #include "curl/curl.h"
 
 namespace STAPPLER_VERSIONIZED stappler::network {
 
 SPUNUSED static CURL *CurlHandle_alloc();
 SPUNUSED static void CurlHandle_release(CURL *curl);
+SPUNUSED static void ShareCache_setupMulti(CURLM *multi);
 
 template <>
 bool Handle<memory::PoolInterface>::init(Method method, StringView url) {
@@ -77,7 +84,13 @@ bool Handle<memory::StandartInterface>::perform() {
 template <>
 bool MultiHandle<memory::PoolInterface>::perform(
 		const Callback<bool(Handle<memory::PoolInterface> *, Ref *)> &cb) {
+	if (async) {
+		log::source().error("CURL", "MultiHandle is already running in async mode");
+		return false;
+	}
+
 	auto m = curl_multi_init();
+	ShareCache_setupMulti(m);
 	memory::PoolInterface::MapType<CURL *, Context<memory::PoolInterface>> handles;
 
 	auto initPending = [&, this]() -> int {
@@ -161,7 +174,13 @@ bool MultiHandle<memory::PoolInterface>::perform(
 template <>
 bool MultiHandle<memory::StandartInterface>::perform(
 		const Callback<bool(Handle<memory::StandartInterface> *, Ref *)> &cb) {
+	if (async) {
+		log::source().error("CURL", "MultiHandle is already running in async mode");
+		return false;
+	}
+
 	auto m = curl_multi_init();
+	ShareCache_setupMulti(m);
 	memory::StandartInterface::MapType<CURL *, Context<memory::StandartInterface>> handles;
 
 	auto initPending = [&, this]() -> int {
@@ -244,4 +263,380 @@ bool MultiHandle<memory::StandartInterface>::perform(
 	return true;
 }
 
+#if MODULE_STAPPLER_EVENT
+
+template <typename Interface>
+struct MultiHandle<Interface>::AsyncData : public Ref {
+	MultiHandle<Interface> *multi = nullptr;
+	CURLM *curlm = nullptr;
+	memory::pool_t *pool = nullptr;
+	Rc<event::Looper> looper;
+	Rc<event::Handle> timer;
+	CompletionCallback callback;
+	std::map<curl_socket_t, Rc<event::PollHandle>> sockets;
+	std::map<CURL *, Context<Interface>> handles;
+	bool pendingScheduled = false;
+
+	// self-reference, keeps data alive until all transfers are done
+	Rc<AsyncData> active;
+
+	static bool start(MultiHandle<Interface> *multi, event::Looper *looper,
+			CompletionCallback &&cb) {
+		if (multi->async) {
+			log::source().error("CURL", "MultiHandle is already running");
+			return false;
+		}
+
+		if (!looper || !looper->isOnThisThread()) {
+			log::source().error("CURL",
+					"MultiHandle::performAsync should be called on looper's thread");
+			return false;
+		}
+
+		auto data = Rc<AsyncData>::create(multi, looper, sp::move(cb));
+		if (!data) {
+			log::source().error("CURL", "Fail to initialize async multi handle");
+			return false;
+		}
+
+		multi->async = data.get();
+		data->schedulePending();
+		return true;
+	}
+
+	static int onSocket(CURL *, curl_socket_t s, int what, void *userp, void *) {
+		static_cast<AsyncData *>(userp)->updateSocket(s, what);
+		return 0;
+	}
+
+	static int onTimer(CURLM *, long timeoutMs, void *userp) {
+		static_cast<AsyncData *>(userp)->updateTimer(timeoutMs);
+		return 0;
+	}
+
+	bool init(MultiHandle<Interface> *m, event::Looper *l, CompletionCallback &&cb) {
+		curlm = curl_multi_init();
+		if (!curlm) {
+			return false;
+		}
+
+		ShareCache_setupMulti(curlm);
+
+		if constexpr (std::is_same_v<Interface, memory::PoolInterface>) {
+			// contexts and callbacks are allocated from the pool, which should outlive transfers
+			pool = memory::pool::acquire();
+		}
+
+		multi = m;
+		looper = l;
+		callback = sp::move(cb);
+
+		curl_multi_setopt(curlm, CURLMOPT_SOCKETFUNCTION, &onSocket);
+		curl_multi_setopt(curlm, CURLMOPT_SOCKETDATA, this);
+		curl_multi_setopt(curlm, CURLMOPT_TIMERFUNCTION, &onTimer);
+		curl_multi_setopt(curlm, CURLMOPT_TIMERDATA, this);
+
+		active = this;
+		return true;
+	}
+
+	template <typename Callback>
+	void perform(const Callback &cb) {
+		if (pool) {
+			memory::pool::perform(cb, pool);
+		} else {
+			cb();
+		}
+	}
+
+	// Pending handles are always started from the looper's queue, because addHandle can be
+	// called from within curl callbacks, where curl_multi_add_handle is forbidden
+	void schedulePending() {
+		if (pendingScheduled || !multi) {
+			return;
+		}
+
+		pendingScheduled = true;
+		looper->performOnThread([this] {
+			pendingScheduled = false;
+			perform([&] { startPending(); });
+		}, this);
+	}
+
+	void startPending() {
+		if (!multi) {
+			return;
+		}
+
+		for (auto &it : multi->pending) {
+			auto h = CurlHandle_alloc();
+			auto i = handles.emplace(h, Context<Interface>()).first;
+			i->second.userdata = it.second;
+			i->second.curl = h;
+			i->second.origHandle = it.first;
+			network::prepare(*getHandleData(it.first), &i->second, nullptr);
+
+			curl_multi_add_handle(curlm, h);
+		}
+		multi->pending.clear();
+
+		if (handles.empty()) {
+			finish();
+		}
+	}
+
+	void updateSocket(curl_socket_t s, int what) {
+		auto it = sockets.find(s);
+		if (what == CURL_POLL_REMOVE) {
+			if (it != sockets.end()) {
+				it->second->cancel();
+				sockets.erase(it);
+			}
+			return;
+		}
+
+		auto flags = event::PollFlags::None;
+		if (what & CURL_POLL_IN) {
+			flags |= event::PollFlags::In;
+		}
+		if (what & CURL_POLL_OUT) {
+			flags |= event::PollFlags::Out;
+		}
+
+		if (it != sockets.end()) {
+			if (it->second->getStatus() == Status::Ok && it->second->reset(flags)) {
+				return;
+			}
+			// handle was stopped by the queue (like, on HUP), replace it
+			it->second->cancel();
+			sockets.erase(it);
+		}
+
+		auto h = looper->listenPollableHandle(event::NativeHandle(s), flags,
+				[this](event::NativeHandle fd, event::PollFlags flags) {
+			perform([&] { onSocketEvent(curl_socket_t(fd), flags); });
+			return Status::Ok;
+		}, this);
+		if (h) {
+			sockets.emplace(s, move(h));
+		}
+	}
+
+	void updateTimer(long timeoutMs) {
+		if (timer) {
+			timer->cancel();
+			timer = nullptr;
+		}
+
+		if (timeoutMs < 0) {
+			return;
+		}
+
+		// zero timeout means 'as soon as possible', but curl_multi_socket_action
+		// can not be called from within the timer callback
+		auto ival = (timeoutMs > 0) ? TimeInterval::milliseconds(timeoutMs)
+									: TimeInterval::microseconds(1);
+		timer = looper->schedule(ival, [this](event::Handle *h, bool success) {
+			if (timer == h) {
+				timer = nullptr;
+			}
+			if (success) {
+				perform([&] { onSocketEvent(CURL_SOCKET_TIMEOUT, event::PollFlags::None); });
+			}
+		}, this);
+	}
+
+	void onSocketEvent(curl_socket_t s, event::PollFlags flags) {
+		if (!curlm) {
+			return;
+		}
+
+		Rc<AsyncData> guard(this);
+
+		int ev = 0;
+		if (hasFlag(flags, event::PollFlags::In)) {
+			ev |= CURL_CSELECT_IN;
+		}
+		if (hasFlag(flags, event::PollFlags::Out)) {
+			ev |= CURL_CSELECT_OUT;
+		}
+		if (hasFlag(flags, event::PollFlags::Err) || hasFlag(flags, event::PollFlags::HungUp)) {
+			ev |= CURL_CSELECT_ERR;
+		}
+
+		int running = 0;
+		auto err = curl_multi_socket_action(curlm, s, ev, &running);
+		if (err != CURLM_OK) {
+			log::source().error("CURL", "Fail to perform multi socket action: ", int(err));
+		}
+
+		processMessages();
+	}
+
+	void processMessages() {
+		struct CURLMsg *msg = nullptr;
+		do {
+			int msgq = 0;
+			msg = curl_multi_info_read(curlm, &msgq);
+			if (msg && (msg->msg == CURLMSG_DONE)) {
+				CURL *e = msg->easy_handle;
+				curl_multi_remove_handle(curlm, e);
+
+				auto it = handles.find(e);
+				if (it != handles.end()) {
+					it->second.code = msg->data.result;
+					network::finalize(*it->second.handle, &it->second, nullptr);
+
+					auto h = it->second.origHandle;
+					auto userdata = move(it->second.userdata);
+					handles.erase(it);
+					CurlHandle_release(e);
+
+					if (callback && !callback(h, userdata.get())) {
+						cancel();
+						return;
+					}
+
+					if (!curlm) {
+						// cancelled from callback
+						return;
+					}
+				} else {
+					CurlHandle_release(e);
+				}
+			}
+		} while (msg);
+
+		if (multi && !multi->pending.empty()) {
+			startPending();
+		} else if (handles.empty()) {
+			finish();
+		}
+	}
+
+	void cancel() {
+		if (!curlm) {
+			return;
+		}
+
+		for (auto &it : handles) {
+			curl_multi_remove_handle(curlm, it.first);
+			it.second.code = CURLE_FAILED_INIT;
+			network::finalize(*it.second.handle, &it.second, nullptr);
+
+			CurlHandle_release(it.first);
+		}
+		handles.clear();
+
+		if (multi) {
+			multi->pending.clear();
+		}
+
+		finish();
+	}
+
+	void finish() {
+		for (auto &it : sockets) { it.second->cancel(); }
+		sockets.clear();
+
+		if (timer) {
+			timer->cancel();
+			timer = nullptr;
+		}
+
+		if (curlm) {
+			curl_multi_cleanup(curlm);
+			curlm = nullptr;
+		}
+
+		if (multi) {
+			multi->async = nullptr;
+			multi = nullptr;
+		}
+
+		callback = nullptr;
+
+		// can release the last reference, should be the last call
+		active = nullptr;
+	}
+};
+
+#endif
+
+template <>
+MultiHandle<memory::PoolInterface>::~MultiHandle() {
+	cancel();
+}
+
+template <>
+MultiHandle<memory::StandartInterface>::~MultiHandle() {
+	cancel();
+}
+
+template <>
+void MultiHandle<memory::PoolInterface>::addHandle(Handle<memory::PoolInterface> *handle,
+		Ref *userdata) {
+	pending.emplace_back(pair(handle, userdata));
+#if MODULE_STAPPLER_EVENT
+	if (async) {
+		async->schedulePending();
+	}
+#endif
+}
+
+template <>
+void MultiHandle<memory::StandartInterface>::addHandle(
+		Handle<memory::StandartInterface> *handle, Ref *userdata) {
+	pending.emplace_back(pair(handle, userdata));
+#if MODULE_STAPPLER_EVENT
+	if (async) {
+		async->schedulePending();
+	}
+#endif
+}
+
+template <>
+bool MultiHandle<memory::PoolInterface>::performAsync(event::Looper *looper,
+		CompletionCallback &&cb) {
+#if MODULE_STAPPLER_EVENT
+	return AsyncData::start(this, looper, sp::move(cb));
+#else
+	log::source().error("CURL", "MultiHandle::performAsync requires stappler_event module");
+	return false;
+#endif
+}
+
+template <>
+bool MultiHandle<memory::StandartInterface>::performAsync(event::Looper *looper,
+		CompletionCallback &&cb) {
+#if MODULE_STAPPLER_EVENT
+	return AsyncData::start(this, looper, sp::move(cb));
+#else
+	log::source().error("CURL", "MultiHandle::performAsync requires stappler_event module");
+	return false;
+#endif
+}
+
+template <>
+void MultiHandle<memory::PoolInterface>::cancel() {
+#if MODULE_STAPPLER_EVENT
+	if (async) {
+		Rc<AsyncData> guard(async);
+		async->cancel();
+	}
+#endif
+	pending.clear();
+}
+
+template <>
+void MultiHandle<memory::StandartInterface>::cancel() {
+#if MODULE_STAPPLER_EVENT
+	if (async) {
+		Rc<AsyncData> guard(async);
+		async->cancel();
+	}
+#endif
+	pending.clear();
+}
+
 } // namespace stappler::network
@@ -26,6 +26,12 @@ THE SOFTWARE.
 
 #include "SPNetworkData.h"
 
+namespace STAPPLER_VERSIONIZED stappler::event {
+
+class Looper;
+
+}
+
 namespace STAPPLER_VERSIONIZED stappler::network {
 
 template <typename Interface>
@@ -89,6 +95,7 @@ public:
 	using DataType::setDebug;
 	using DataType::setReuse;
 	using DataType::setShared;
+	using DataType::setShareCache;
 	using DataType::setSilent;
 	using DataType::getDebugData;
 	using DataType::setDownloadProgress;
@@ -110,18 +117,47 @@ protected:
 template <typename Interface>
 class SP_PUBLIC MultiHandle : public Interface::AllocBaseType {
 public:
+	using CompletionCallback =
+			typename Interface::template FunctionType<bool(Handle<Interface> *, Ref *)>;
+
+	MultiHandle() = default;
+	~MultiHandle();
+
+	MultiHandle(const MultiHandle &) = delete;
+	MultiHandle &operator=(const MultiHandle &) = delete;
+
 	// handle should be preserved until operation ends
 	// multihandle do not stores handles by itself
-	void addHandle(Handle<Interface> *handle, Ref *userdata) {
-		pending.emplace_back(pair(handle, userdata));
-	}
+	// in async mode, should be called on looper's thread, handle will be started
+	// on the next looper iteration
+	void addHandle(Handle<Interface> *handle, Ref *userdata);
 
 	// sync interface:
 	// returns completed handles, so it can be immediately recharged with addHandle
 	bool perform(const Callback<bool(Handle<Interface> *, Ref *)> &);
 
+	// async interface (requires stappler_event module):
+	// curl sockets and timers are driven by the looper, so its thread is never blocked,
+	// and one looper can serve any number of transfers in flight.
+	// Completed handles are delivered into callback on the looper's thread, so it can be
+	// immediately recharged with addHandle; return false to cancel all other handles
+	//
+	// Should be called on the looper's thread. MultiHandle should be preserved until
+	// all handles are completed (isRunning() returns false) or cancelled.
+	bool performAsync(event::Looper *, CompletionCallback &&);
+
+	// cancel async operation; callback will not be called for the remaining handles
+	void cancel();
+
+	bool isRunning() const { return async != nullptr; }
+
 protected:
+	struct AsyncData;
+
+	static HandleData<Interface> *getHandleData(Handle<Interface> *h) { return h->getData(); }
+
 	typename Interface::template VectorType<Pair<Handle<Interface> *, Rc<Ref>>> pending;
+	AsyncData *async = nullptr;
 };
 
 }
@@ -46,6 +46,11 @@ SPUNUSED static CURL *CurlHandle_getHandle(bool reuse, memory::pool_t *pool);
 SPUNUSED static void CurlHandle_releaseHandle(CURL *curl, bool reuse, bool success,
 		memory::pool_t *pool);
 
+SPUNUSED static CURLSH *ShareCache_get();
+SPUNUSED static bool ShareCache_isCookiesShared();
+SPUNUSED static void ShareCache_setup(CURL *curl);
+SPUNUSED static void ShareCache_onTransferComplete(CURL *curl, bool success);
+
 static size_t _writeDummy(const void *data, size_t size, size_t nmemb, void *userptr) {
 	return size * nmemb;
 }
@@ -657,6 +662,18 @@ bool prepare(HandleData<Interface> &iface, Context<Interface> *ctx,
 		}
 		SetOpt(check, ctx->curl, CURLOPT_COOKIEFILE, "/undefined");
 		SetOpt(check, ctx->curl, CURLOPT_SHARE, iface.process.sharedHandle);
+	} else if (iface.process.shareCache) {
+		if (auto share = ShareCache_get()) {
+			if (ShareCache_isCookiesShared() && iface.process.cookieFile.empty()) {
+				// enable cookie engine to use shared cookies
+				SetOpt(check, ctx->curl, CURLOPT_COOKIEFILE, "");
+			}
+			SetOpt(check, ctx->curl, CURLOPT_SHARE, share);
+			ShareCache_setup(ctx->curl);
+			ctx->shareCache = true;
+		} else {
+			SetOpt(check, ctx->curl, CURLOPT_SHARE, nullptr);
+		}
 	} else {
 		SetOpt(check, ctx->curl, CURLOPT_SHARE, nullptr);
 	}
@@ -742,6 +759,10 @@ bool finalize(HandleData<Interface> &iface, Context<Interface> *ctx,
 		}
 	}
 
+	if (ctx->shareCache) {
+		ShareCache_onTransferComplete(ctx->curl, CURLE_OK == iface.process.errorCode);
+	}
+
 	if (CURLE_OK == iface.process.errorCode) {
 		iface.process.performed = true;
 		if (iface.send.method != Method::Smtp) {
@@ -28,6 +28,7 @@
 #include "SPPugContext.cc"
 #include "SPPugExpression.cc"
 #include "SPPugLexer.cc"
+#include "SPPugOutput.cc"
 #include "SPPugTemplate.cc"
 #include "SPPugToken.cc"
 #include "SPPugVariable.cc"
@@ -61,14 +61,13 @@ CacheFile::CacheFile(Ref *ref, memory::pool_t *pool, const FileInfo &path, Templ
 		const Callback<void(const StringView &)> &cb, int watch, int wId)
 : PoolObject(ref, pool), _opts(opts) {
 
-	filesystem::Stat stat;
-	filesystem::stat(path, stat);
-
-	_mtime = stat.mtime;
-	_content.resize(stat.size);
-	filesystem::readIntoBuffer((uint8_t *)_content.data(), path);
+	// template sources are shared with other FileCache users and not re-read when not modified
+	_data = filesystem::FileCache::getInstance()->read(path);
+	if (_data) {
+		_mtime = _data->getStat().mtime;
+	}
 
-	if (_content.size() > 0) {
+	if (_data && _data->getBytes().size() > 0) {
 		if (wId < 0 && watch >= 0) {
 #if 0 && LINUX
 			_watch = inotify_add_watch(watch, SP_TERMINATED_DATA(fpath), s_FileNotifyMask);
@@ -88,7 +87,7 @@ CacheFile::CacheFile(Ref *ref, memory::pool_t *pool, const FileInfo &path, Templ
 	if (_valid
 			&& (path.path.ends_with(".pug") || path.path.ends_with(".stl")
 					|| path.path.ends_with(".spug"))) {
-		_template = Template::read(_pool, _content, opts, cb);
+		_template = Template::read(_pool, _data->getString(), opts, cb);
 		if (!_template) {
 			_valid = false;
 		}
@@ -114,7 +113,9 @@ CacheFile::CacheFile(Ref *ref, memory::pool_t *pool, StringView key, String &&sr
 
 CacheFile::~CacheFile() { }
 
-StringView CacheFile::getContent() const { return _content; }
+StringView CacheFile::getContent() const {
+	return _data ? _data->getString() : StringView(_content);
+}
 
 const Template *CacheFile::getTemplate() const { return _template; }
 
@@ -280,6 +281,26 @@ bool Cache::runTemplate(StringView key, const RunCallback &cb, const OutStream &
 	return false;
 }
 
+bool Cache::runTemplate(const FileInfo &ipath, const RunCallback &cb, OutputBuffer &buf,
+		const OutIovec &writer) {
+	buf.clear();
+	auto ret = runTemplate(ipath, cb, [&](StringView str) { buf.write(str); });
+	if (!buf.empty()) {
+		writer(buf.getIovec());
+	}
+	return ret;
+}
+
+bool Cache::runTemplate(StringView key, const RunCallback &cb, OutputBuffer &buf,
+		const OutIovec &writer) {
+	buf.clear();
+	auto ret = runTemplate(key, cb, [&](StringView str) { buf.write(str); });
+	if (!buf.empty()) {
+		writer(buf.getIovec());
+	}
+	return ret;
+}
+
 bool Cache::addFile(const FileInfo &path) {
 	auto key = filepath::canonical<memory::StandartInterface>(path);
 
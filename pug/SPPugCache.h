@@ -24,6 +24,7 @@
 #define EXTRA_WEBSERVER_PUG_SPPUGCACHE_H_
 
 #include "SPFilepath.h"
+#include "SPFilesystemCache.h"
 #include "SPPug.h"
 #include "SPPugTemplate.h"
 
@@ -62,6 +63,7 @@ protected:
 	int _watch = -1;
 	Time _mtime = Time();
 	String _content;
+	Rc<filesystem::FileCacheData> _data; // shared file contents, when loaded from file
 	Template * _template = nullptr;
 	Template::Options _opts;
 	bool _valid = false;
@@ -71,6 +73,7 @@ protected:
 class SP_PUBLIC Cache : public memory::AllocPool {
 public:
 	using OutStream = Callback<void(StringView)>;
+	using OutIovec = Template::OutIovec;
 	using RunCallback = Callback<bool(Context &, const Template &)>;
 	using Options = Template::Options;
 
@@ -85,6 +88,10 @@ public:
 	bool runTemplate(StringView, const RunCallback &, const OutStream &);
 	bool runTemplate(StringView, const RunCallback &, const OutStream &, Template::Options opts);
 
+	// run into buffer, writer is called once with iovec list of the whole output
+	bool runTemplate(const FileInfo &, const RunCallback &, OutputBuffer &, const OutIovec &);
+	bool runTemplate(StringView, const RunCallback &, OutputBuffer &, const OutIovec &);
+
 	bool addFile(const FileInfo &);
 	
 	// add with preloaded data
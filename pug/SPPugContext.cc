@@ -22,6 +22,7 @@
 
 #include "SPPugContext.h"
 #include "SPPugVariable.h"
+#include "SPPugOutput.h"
 
 namespace STAPPLER_VERSIONIZED stappler::pug {
 
@@ -395,18 +396,7 @@ Var ContextFn::execExpr(const Expression &expr, Expression::Op op, bool assignab
 static void ContextFn_printEscapedString(const StringView &str, const ContextFn::OutStream &out,
 		bool escapeOutput) {
 	if (escapeOutput) {
-		StringView r(str);
-		while (!r.empty()) {
-			out << r.readUntil<StringView::Chars<'&', '<', '>', '"', '\''>>();
-			switch (r[0]) {
-			case '&': out << "&amp;"; break;
-			case '<': out << "&lt;"; break;
-			case '>': out << "&gt;"; break;
-			case '"': out << "&quot;"; break;
-			case '\'': out << "&#39;"; break;
-			}
-			++r;
-		}
+		writeEscapedHtml(str, out);
 	} else {
 		out << str;
 	}
@@ -0,0 +1,181 @@
+/**
+ Copyright (c) 2025 Stappler LLC <admin@stappler.dev>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ **/
+
+#include "SPPugOutput.h"
+
+namespace STAPPLER_VERSIONIZED stappler::pug {
+
+static constexpr uint64_t OutputLowBits = 0x0101'0101'0101'0101ULL;
+static constexpr uint64_t OutputHighBits = 0x8080'8080'8080'8080ULL;
+
+// non-zero if any byte of word is equal to c
+static inline uint64_t Output_hasByte(uint64_t w, uint8_t c) {
+	auto v = w ^ (OutputLowBits * c);
+	return (v - OutputLowBits) & ~v & OutputHighBits;
+}
+
+static inline bool Output_isSpecial(char c) {
+	switch (c) {
+	case '&':
+	case '<':
+	case '>':
+	case '"':
+	case '\'': return true;
+	default: break;
+	}
+	return false;
+}
+
+static inline StringView Output_getEntity(char c) {
+	switch (c) {
+	case '&': return StringView("&amp;"); break;
+	case '<': return StringView("&lt;"); break;
+	case '>': return StringView("&gt;"); break;
+	case '"': return StringView("&quot;"); break;
+	case '\'': return StringView("&#39;"); break;
+	default: break;
+	}
+	return StringView();
+}
+
+// returns length of the prefix without special chars
+static size_t Output_scanPlain(const char *data, size_t size) {
+	size_t i = 0;
+	while (i + sizeof(uint64_t) <= size) {
+		uint64_t w;
+		memcpy(&w, data + i, sizeof(uint64_t));
+		if ((Output_hasByte(w, '&') | Output_hasByte(w, '<') | Output_hasByte(w, '>')
+					| Output_hasByte(w, '"') | Output_hasByte(w, '\''))
+				!= 0) {
+			break;
+		}
+		i += sizeof(uint64_t);
+	}
+	while (i < size && !Output_isSpecial(data[i])) { ++i; }
+	return i;
+}
+
+template <typename Callback>
+static void Output_escape(StringView str, const Callback &cb) {
+	while (!str.empty()) {
+		auto plain = Output_scanPlain(str.data(), str.size());
+		if (plain > 0) {
+			cb(StringView(str.data(), plain));
+			str += plain;
+		}
+		if (!str.empty()) {
+			cb(Output_getEntity(str[0]));
+			++str;
+		}
+	}
+}
+
+void writeEscapedHtml(StringView str, const Callback<void(StringView)> &out) {
+	static constexpr size_t BufferSize = 512;
+
+	auto plain = Output_scanPlain(str.data(), str.size());
+	if (plain == str.size()) {
+		out << str;
+		return;
+	}
+
+	std::array<char, BufferSize> buf;
+	size_t used = 0;
+
+	auto flush = [&] {
+		if (used > 0) {
+			out << StringView(buf.data(), used);
+			used = 0;
+		}
+	};
+
+	Output_escape(str, [&](StringView s) {
+		if (used + s.size() > buf.size()) {
+			flush();
+			if (s.size() > buf.size() / 2) {
+				out << s;
+				return;
+			}
+		}
+		memcpy(buf.data() + used, s.data(), s.size());
+		used += s.size();
+	});
+
+	flush();
+}
+
+OutputBuffer::OutputBuffer(size_t chunkSize)
+: _pool(memory::pool::acquire()), _chunkSize(chunkSize) { }
+
+void OutputBuffer::write(StringView str) {
+	if (str.empty()) {
+		return;
+	}
+
+	if (!_chunks.empty() && _chunks.back().iov_len + str.size() <= _capacity) {
+		auto &last = _chunks.back();
+		memcpy((char *)last.iov_base + last.iov_len, str.data(), str.size());
+		last.iov_len += str.size();
+		_size += str.size();
+		return;
+	}
+
+	// fill the rest of the last chunk, then continue in the new one
+	if (!_chunks.empty() && _chunks.back().iov_len < _capacity) {
+		auto &last = _chunks.back();
+		auto len = _capacity - last.iov_len;
+		memcpy((char *)last.iov_base + last.iov_len, str.data(), len);
+		last.iov_len += len;
+		_size += len;
+		str += len;
+	}
+
+	auto buf = allocate(str.size());
+	memcpy(buf, str.data(), str.size());
+	_chunks.back().iov_len = str.size();
+	_size += str.size();
+}
+
+void OutputBuffer::clear() {
+	// chunks memory is owned by pool, so it will be freed with it
+	_chunks.clear();
+	_capacity = 0;
+	_size = 0;
+}
+
+String OutputBuffer::str() const {
+	String ret;
+	ret.reserve(_size);
+	for (auto &it : _chunks) { ret.append((const char *)it.iov_base, it.iov_len); }
+	return ret;
+}
+
+char *OutputBuffer::allocate(size_t size) {
+	auto capacity = std::max(size, _chunkSize);
+	auto buf = (char *)memory::pool::palloc(_pool, capacity);
+
+	_chunks.emplace_back(iovec{buf, 0});
+	_capacity = capacity;
+	return buf;
+}
+
+} // namespace stappler::pug
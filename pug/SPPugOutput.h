@@ -0,0 +1,90 @@
+/**
+ Copyright (c) 2025 Stappler LLC <admin@stappler.dev>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ **/
+
+#ifndef EXTRA_WEBSERVER_PUG_SPPUGOUTPUT_H_
+#define EXTRA_WEBSERVER_PUG_SPPUGOUTPUT_H_
+
+#include "SPPug.h"
+
+#if WIN32
+namespace STAPPLER_VERSIONIZED stappler::pug {
+
+struct iovec {
+	void *iov_base;
+	size_t iov_len;
+};
+
+}
+#else
+#include <sys/uio.h>
+#endif
+
+namespace STAPPLER_VERSIONIZED stappler::pug {
+
+// Writes HTML-escaped string into stream; plain runs are detected word-by-word,
+// and the output is batched, so stream is called once per block instead of per character
+SP_PUBLIC void writeEscapedHtml(StringView, const Callback<void(StringView)> &);
+
+// Pool-backed chunked buffer for template output, uses current pool for allocations
+// Fragments are copied into chunks of fixed size, resulting chunks can be sent with writev
+// Used by buffered Template::run and Cache::runTemplate:
+//   pug::OutputBuffer buf;
+//   tpl->run(ctx, buf, [&](SpanView<iovec> iov) { ::writev(fd, iov.data(), int(iov.size())); });
+class SP_PUBLIC OutputBuffer : public memory::AllocPool {
+public:
+	static constexpr size_t DefaultChunkSize = 16_KiB;
+
+	OutputBuffer(size_t chunkSize = DefaultChunkSize);
+
+	OutputBuffer(const OutputBuffer &) = delete;
+	OutputBuffer &operator=(const OutputBuffer &) = delete;
+
+	void write(StringView);
+
+	// iovec list, that points into chunks; valid until next write or clear
+	SpanView<iovec> getIovec() const { return _chunks; }
+
+	size_t size() const { return _size; }
+	bool empty() const { return _size == 0; }
+
+	void clear();
+
+	String str() const;
+
+	OutputBuffer &operator<<(StringView str) {
+		write(str);
+		return *this;
+	}
+
+protected:
+	char *allocate(size_t);
+
+	memory::pool_t *_pool = nullptr;
+	size_t _chunkSize = DefaultChunkSize;
+	size_t _size = 0;
+	size_t _capacity = 0; // capacity of the last chunk
+	Vector<iovec> _chunks;
+};
+
+}
+
+#endif /* EXTRA_WEBSERVER_PUG_SPPUGOUTPUT_H_ */
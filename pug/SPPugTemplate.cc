@@ -615,6 +615,7 @@ Template::Template(memory::pool_t *p, const StringView &str, const Options &opts
 		renderer.flushBuffer();
 		renderer.end();
 		_includes = move(renderer.extractIncludes());
+		prepareChunk(_root);
 	}
 }
 
@@ -627,6 +628,20 @@ bool Template::run(Context &ctx, const OutStream &out, const Options &opts) cons
 	return run(ctx, out, rctx);
 }
 
+bool Template::run(Context &ctx, OutputBuffer &buf, const OutIovec &writer) const {
+	return run(ctx, buf, writer, _opts);
+}
+
+bool Template::run(Context &ctx, OutputBuffer &buf, const OutIovec &writer,
+		const Options &opts) const {
+	buf.clear();
+	auto ret = run(ctx, [&](StringView str) { buf.write(str); }, opts);
+	if (!buf.empty()) {
+		writer(buf.getIovec());
+	}
+	return ret;
+}
+
 bool Template::run(Context &ctx, const OutStream &out, RunContext &rctx) const {
 	rctx.templateStack.emplace_back(this);
 	auto ret = runChunk(_root, ctx, out, rctx);
@@ -704,6 +719,87 @@ static void Template_readMixinArgs(Vector<Expression *> &vars, Expression *expr)
 	}
 }
 
+static Template::TagName Template_getTagName(StringView value) {
+	std::array<char, 5> buf;
+	auto len = std::min(value.size(), buf.size());
+	for (size_t i = 0; i < len; ++i) { buf[i] = char(::tolower(value[i])); }
+
+	StringView name(buf.data(), len);
+	if (name == "<html" || name == "</htm") {
+		return Template::TagHtml;
+	} else if (name == "<head" || name == "</hea") {
+		return Template::TagHead;
+	} else if (name == "<body" || name == "</bod") {
+		return Template::TagBody;
+	}
+	return Template::TagOther;
+}
+
+// Static text is written right after opening tag or another static text, so it can be appended
+// to them; closing tags are not merged, because line feed can be written after them
+static bool Template_canAppendText(const Template::Chunk &prev, StringView text) {
+	switch (prev.type) {
+	case Template::HtmlEntity:
+	case Template::HtmlInlineTag: return true; break;
+	case Template::HtmlTag: {
+		StringView value(prev.value);
+		if (value.starts_with("</")) {
+			return false;
+		}
+		// self-closing check should give the same result for merged value
+		auto merged = string::toString<memory::PoolInterface>(value, text);
+		return value.ends_with("/>") == StringView(merged).ends_with("/>");
+	}
+	default: break;
+	}
+	return false;
+}
+
+static void Template_mergeStaticText(Template::Chunk &chunk) {
+	size_t target = 0;
+	for (size_t i = 0; i < chunk.chunks.size(); ++i) {
+		auto c = chunk.chunks[i];
+		if (c->type == Template::HtmlEntity && target > 0
+				&& Template_canAppendText(*chunk.chunks[target - 1], c->value)) {
+			chunk.chunks[target - 1]->value.append(c->value.data(), c->value.size());
+			continue;
+		}
+		chunk.chunks[target++] = c;
+	}
+	chunk.chunks.resize(target);
+}
+
+void Template::prepareChunk(Chunk &chunk) {
+	switch (chunk.type) {
+	case HtmlTag:
+	case HtmlInlineTag: chunk.tag = Template_getTagName(chunk.value); break;
+	case MixinCall: {
+		Vector<Expression *> vars;
+		Template_readMixinArgs(vars, chunk.expr);
+		if (!vars.empty()) {
+			auto args = (Expression **)memory::pool::palloc(_pool,
+					sizeof(Expression *) * vars.size());
+			memcpy(args, vars.data(), sizeof(Expression *) * vars.size());
+			chunk.args = SpanView<Expression *>(args, vars.size());
+		}
+		break;
+	}
+	default: break;
+	}
+
+	// tag names are resolved for children below, from value prefix, that is not changed by merge
+	Template_mergeStaticText(chunk);
+
+	for (auto &it : chunk.chunks) { prepareChunk(*it); }
+}
+
+static Template::Chunk *Template_makeVirtualTag(Template::TagName tag) {
+	auto c = new Template::Chunk{Template::VirtualTag,
+		String((tag == Template::TagHtml) ? "</html>" : "</body>"), nullptr};
+	c->tag = tag;
+	return c;
+}
+
 bool Template::runChunk(const Chunk &chunk, Context &exec, const Callback<void(StringView)> &out,
 		RunContext &tagStack) const {
 	auto onError = [&](const StringView &err) SP_COVERAGE_TRIVIAL {
@@ -922,8 +1018,7 @@ bool Template::runChunk(const Chunk &chunk, Context &exec, const Callback<void(S
 			return true;
 		}
 
-		Vector<Expression *> vars;
-		Template_readMixinArgs(vars, ch.expr);
+		auto &vars = ch.args;
 
 		if (vars.size() < mixin->required) {
 			onError(string::toString<memory::PoolInterface>("Not enough arguments for mixin: ",
@@ -968,25 +1063,17 @@ bool Template::runChunk(const Chunk &chunk, Context &exec, const Callback<void(S
 		case HtmlTag:
 			if (StringView(c.value).starts_with("</")) {
 				while (!tagStack.tagStack.empty() && tagStack.tagStack.back()->type == VirtualTag) {
-					auto name = StringView(tagStack.tagStack.back()->value, 5)
-										.str<memory::PoolInterface>();
-					string::apply_tolower_c(name);
+					// withinBody stays set after virtual </body>, so no second <body> is opened
 					out << tagStack.tagStack.back()->value;
-					if (name == "</body") {
-						tagStack.withinBody = false;
-					}
 					tagStack.tagStack.pop_back();
 				}
 				if (tagStack.tagStack.empty()) {
 					return false;
 				}
-				auto name =
-						StringView(tagStack.tagStack.back()->value, 5).str<memory::PoolInterface>();
-				string::apply_tolower_c(name);
-				if (name == "<head") {
-					tagStack.withinHead = false;
-				} else if (name == "<body") {
-					tagStack.withinBody = false;
+				switch (tagStack.tagStack.back()->tag) {
+				case TagHead: tagStack.withinHead = false; break;
+				case TagBody: tagStack.withinBody = false; break;
+				default: break;
 				}
 				out << c.value;
 				tagStack.tagStack.pop_back();
@@ -997,25 +1084,21 @@ bool Template::runChunk(const Chunk &chunk, Context &exec, const Callback<void(S
 				if (tagStack.opts.hasFlag(Options::LineFeeds) && !tagStack.tagStack.empty()) {
 					out << "\n";
 				}
-				auto name = StringView(c.value, 5).str<memory::PoolInterface>();
-				string::apply_tolower_c(name);
-				if (tagStack.tagStack.empty() && name != "<html") {
+				if (tagStack.tagStack.empty() && c.tag != TagHtml) {
 					out << "<html>";
-					tagStack.tagStack.push_back(
-							new Template::Chunk{VirtualTag, String("</html>"), nullptr});
+					tagStack.tagStack.push_back(Template_makeVirtualTag(TagHtml));
 				}
-				if (name == "<html") {
+				if (c.tag == TagHtml) {
 					tagStack.tagStack.push_back(&c);
 				} else {
-					if (name == "<head") {
+					if (c.tag == TagHead) {
 						tagStack.withinHead = true;
 					} else if (!tagStack.withinHead) {
-						if (name == "<body") {
+						if (c.tag == TagBody) {
 							tagStack.withinBody = true;
 						} else if (!tagStack.withinBody) {
 							out << "<body>";
-							tagStack.tagStack.push_back(
-									new Template::Chunk{VirtualTag, String("</body>"), nullptr});
+							tagStack.tagStack.push_back(Template_makeVirtualTag(TagBody));
 							tagStack.withinBody = true;
 						}
 					}
@@ -1031,18 +1114,14 @@ bool Template::runChunk(const Chunk &chunk, Context &exec, const Callback<void(S
 			++it;
 			break;
 		case HtmlInlineTag: {
-			auto name = StringView(c.value, 5).str<memory::PoolInterface>();
-			string::apply_tolower_c(name);
-			if (tagStack.tagStack.empty() && name != "<html") {
+			if (tagStack.tagStack.empty() && c.tag != TagHtml) {
 				out << "<html>";
-				tagStack.tagStack.push_back(
-						new Template::Chunk{VirtualTag, String("</html>"), nullptr});
+				tagStack.tagStack.push_back(Template_makeVirtualTag(TagHtml));
 			}
-			if (name != "<head" && !tagStack.withinHead) {
-				if (name != "<body" && !tagStack.withinBody) {
+			if (c.tag != TagHead && !tagStack.withinHead) {
+				if (c.tag != TagBody && !tagStack.withinBody) {
 					out << "<body>";
-					tagStack.tagStack.push_back(
-							new Template::Chunk{VirtualTag, String("</body>"), nullptr});
+					tagStack.tagStack.push_back(Template_makeVirtualTag(TagBody));
 					tagStack.withinBody = true;
 				}
 			}
@@ -1185,6 +1264,7 @@ bool Template::runCase(const Chunk &chunk, Context &exec, const OutStream &out,
 				if ((*it)->chunks.size() > 0) {
 					return runChunk(**it, exec, out, tagStack);
 				}
+				++it;
 			}
 		}
 		return false;
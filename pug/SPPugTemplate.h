@@ -24,12 +24,14 @@
 #define EXTRA_WEBSERVER_PUG_SPPUGTEMPLATE_H_
 
 #include "SPPugLexer.h"
+#include "SPPugOutput.h"
 
 namespace STAPPLER_VERSIONIZED stappler::pug {
 
 class SP_PUBLIC Template : public memory::AllocPool {
 public:
 	using OutStream = Callback<void(StringView)>;
+	using OutIovec = Callback<void(SpanView<iovec>)>;
 
 	enum ChunkType {
 		Block,
@@ -66,12 +68,24 @@ public:
 		VirtualTag,
 	};
 
+	// Tag names, that affects implicit <html> and <body> generation
+	enum TagName : uint8_t {
+		TagOther,
+		TagHtml,
+		TagHead,
+		TagBody,
+	};
+
 	struct Chunk {
 		ChunkType type = Block;
 		String value;
 		Expression *expr = nullptr;
 		size_t indent = 0;
 		Vector<Chunk *> chunks;
+
+		// resolved when template is loaded, so rendering does not need to re-parse it
+		TagName tag = TagOther; // for HtmlTag, HtmlInlineTag and VirtualTag
+		SpanView<Expression *> args; // for MixinCall
 	};
 
 	struct Options {
@@ -112,11 +126,19 @@ public:
 	bool run(Context &, const OutStream &, const Options &opts) const;
 	bool run(Context &, const OutStream &, RunContext &opts) const;
 
+	// Renders into buffer (previous contents are dropped), then writer is called once
+	// with the whole output, instead of a call per fragment
+	bool run(Context &, OutputBuffer &, const OutIovec &) const;
+	bool run(Context &, OutputBuffer &, const OutIovec &, const Options &opts) const;
+
 	void describe(const OutStream &stream, bool tokens = false) const;
 
 protected:
 	Template(memory::pool_t *, const StringView &, const Options &opts, const OutStream &err);
 
+	// resolves tag names and mixin args, merges adjacent static text
+	void prepareChunk(Chunk &chunk);
+
 	bool runChunk(const Chunk &chunk, Context &, const OutStream &, RunContext &) const;
 	bool runCase(const Chunk &chunk, Context &, const OutStream &, RunContext &) const;
 
@@ -26,6 +26,7 @@ THE SOFTWARE.
 #include "SPSearchDistance.cc"
 #include "SPSearchDistanceEdLib.cc"
 #include "SPSearchIndex.cc"
+#include "SPSearchInvertedIndex.cc"
 #include "SPSearchParser.cc"
 #include "SPSearchQuery.cc"
 #include "SPSearchUrl.cc"
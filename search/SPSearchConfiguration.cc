@@ -27,6 +27,10 @@ THE SOFTWARE.
 #include "SPData.h"
 #include <inttypes.h>
 
+#if MODULE_STAPPLER_THREADS
+#include "SPThreadPool.h"
+#endif
+
 namespace STAPPLER_VERSIONIZED stappler::search {
 
 static StemmerEnv *Configuration_makeLocalConfig(StemmerEnv *orig);
@@ -167,6 +171,151 @@ static bool stemWordDefault(Language lang, StemmerEnv *env, ParserToken tok, Str
 	return true;
 }
 
+// Bounded word->stem cache for default stemmers
+//
+// Direct-mapped table of fixed-size slots; every slot is guarded by its own seqlock, so readers
+// never block and never retry (torn or busy slot is just a miss), and writer, that lost the race
+// for a slot, skips the store. Only words up to MaxWordSize bytes are cached, results for longer
+// words are rare enough to be computed every time.
+struct Configuration_StemCache {
+	static constexpr size_t MaxWordSize = 32;
+	static constexpr size_t SlotWords = MaxWordSize / sizeof(uint64_t);
+	static constexpr size_t DefaultSlots = 1 << 14;
+
+	enum Status : uint8_t {
+		Empty,
+		Stopword,
+		Stemmed,
+	};
+
+	struct Slot {
+		std::atomic<uint32_t> seq = 0;
+		// generation:16, class:8, wordSize:8, stemSize:8, status:8
+		std::atomic<uint64_t> meta = 0;
+		std::atomic<uint64_t> word[SlotWords];
+		std::atomic<uint64_t> stem[SlotWords];
+	};
+
+	struct Key {
+		uint64_t data[SlotWords] = {0};
+		uint64_t meta = 0;
+		size_t words = 0;
+		size_t hash = 0;
+	};
+
+	Slot *slots = nullptr;
+	size_t mask = 0;
+	std::atomic<uint16_t> generation = 0;
+
+	// next retired cache, see Configuration::setStemCacheSize
+	Configuration_StemCache *retired = nullptr;
+
+	static uint64_t makeMeta(uint16_t gen, uint8_t cls, size_t wordSize, size_t stemSize,
+			Status st) {
+		return (uint64_t(gen) << 32) | (uint64_t(cls) << 24) | (uint64_t(wordSize) << 16)
+				| (uint64_t(stemSize) << 8) | uint64_t(st);
+	}
+
+	Configuration_StemCache(size_t count) : slots(new Slot[count]), mask(count - 1) { }
+
+	~Configuration_StemCache() { delete[] slots; }
+
+	Key makeKey(StringView word, uint8_t cls) const {
+		Key key;
+		memcpy(key.data, word.data(), word.size());
+		key.meta = makeMeta(generation.load(std::memory_order_relaxed), cls, word.size(), 0, Empty);
+		key.words = (word.size() + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+		key.hash = size_t(hash::hash64(word.data(), word.size(), cls));
+		return key;
+	}
+
+	// on hit, stem is written into buf
+	Status get(const Key &key, char *buf, size_t &size) const {
+		auto &slot = slots[key.hash & mask];
+		auto seq = slot.seq.load(std::memory_order_acquire);
+		if (seq & 1) {
+			return Empty;
+		}
+
+		auto meta = slot.meta.load(std::memory_order_relaxed);
+		if ((meta & ~uint64_t(0xFFFF)) != key.meta) {
+			return Empty;
+		}
+
+		for (size_t i = 0; i < key.words; ++i) {
+			if (slot.word[i].load(std::memory_order_relaxed) != key.data[i]) {
+				return Empty;
+			}
+		}
+
+		uint64_t stem[SlotWords];
+		for (size_t i = 0; i < SlotWords; ++i) {
+			stem[i] = slot.stem[i].load(std::memory_order_relaxed);
+		}
+
+		std::atomic_thread_fence(std::memory_order_acquire);
+		if (slot.seq.load(std::memory_order_relaxed) != seq) {
+			return Empty;
+		}
+
+		size = (meta >> 8) & 0xFF;
+		memcpy(buf, stem, size);
+		return Status(meta & 0xFF);
+	}
+
+	void set(const Key &key, Status st, StringView stem) {
+		auto &slot = slots[key.hash & mask];
+		auto seq = slot.seq.load(std::memory_order_relaxed);
+		if ((seq & 1) || !slot.seq.compare_exchange_strong(seq, seq + 1, std::memory_order_acquire)) {
+			return;
+		}
+		std::atomic_thread_fence(std::memory_order_release);
+
+		uint64_t data[SlotWords] = {0};
+		memcpy(data, stem.data(), stem.size());
+
+		slot.meta.store(key.meta | (uint64_t(stem.size()) << 8) | uint64_t(st),
+				std::memory_order_relaxed);
+		for (size_t i = 0; i < SlotWords; ++i) {
+			slot.word[i].store(key.data[i], std::memory_order_relaxed);
+			slot.stem[i].store(data[i], std::memory_order_relaxed);
+		}
+
+		slot.seq.store(seq + 2, std::memory_order_release);
+	}
+
+	// drop all results, computed with previous language or stopwords
+	void invalidate() { generation.fetch_add(1, std::memory_order_relaxed); }
+};
+
+
+// Words of the same class are stemmed with the same environment, so they can share cache entries;
+// zero means, that result for the token should not be cached
+static uint8_t Configuration_getStemClass(ParserToken tok) {
+	switch (tok) {
+	case ParserToken::AsciiWord:
+	case ParserToken::AsciiHyphenatedWord:
+	case ParserToken::HyphenatedWord_AsciiPart: return 1; break;
+	case ParserToken::Word:
+	case ParserToken::HyphenatedWord:
+	case ParserToken::HyphenatedWord_Part: return 2; break;
+	case ParserToken::NumWord:
+	case ParserToken::NumHyphenatedWord:
+	case ParserToken::HyphenatedWord_NumPart:
+	case ParserToken::Email:
+	case ParserToken::Url:
+	case ParserToken::Version:
+	case ParserToken::Path:
+	case ParserToken::Integer:
+	case ParserToken::Float:
+	case ParserToken::ScientificFloat:
+	case ParserToken::XMLEntity:
+	case ParserToken::Custom:
+	case ParserToken::Blank: break;
+	}
+	return 0;
+}
+
 struct Configuration::Data : AllocBase {
 	pool_t *pool = nullptr;
 	std::atomic<uint32_t> refCount = 1;
@@ -179,12 +328,49 @@ struct Configuration::Data : AllocBase {
 	PreStemCallback preStem;
 	const StringView *customStopwords = nullptr;
 
+	std::atomic<size_t> stemCacheSize = Configuration_StemCache::DefaultSlots;
+	std::atomic<Configuration_StemCache *> stemCache = nullptr;
+
+	// replaced caches can still be used by concurrent stemWord calls, so they are freed only
+	// with configuration itself
+	Configuration_StemCache *retiredStemCache = nullptr;
+
 	Data(pool_t *p, Language lang)
 	: pool(p)
 	, language(lang)
 	, primary(search::getStemmer(language))
 	, secondary(search::getStemmer(
 			  (lang == Language::Simple) ? Language::Simple : Language::English)) { }
+
+	~Data() {
+		delete stemCache.load();
+		while (retiredStemCache) {
+			auto next = retiredStemCache->retired;
+			delete retiredStemCache;
+			retiredStemCache = next;
+		}
+	}
+
+	// cache is allocated on first use, so short-living configurations do not pay for it
+	Configuration_StemCache *getStemCache() {
+		auto cache = stemCache.load(std::memory_order_acquire);
+		if (cache || !stemCacheSize) {
+			return cache;
+		}
+
+		auto tmp = new Configuration_StemCache(stemCacheSize);
+		if (stemCache.compare_exchange_strong(cache, tmp, std::memory_order_acq_rel)) {
+			return tmp;
+		}
+		delete tmp;
+		return cache;
+	}
+
+	void invalidateStemCache() {
+		if (auto cache = stemCache.load()) {
+			cache->invalidate();
+		}
+	}
 };
 
 Configuration::Configuration() : Configuration(Language::English) { }
@@ -213,6 +399,7 @@ void Configuration::setLanguage(Language lang) {
 		if (prevSec != newSec) {
 			data->secondary = search::getStemmer(newSec);
 		}
+		data->invalidateStemCache();
 	}, data->pool);
 }
 
@@ -235,7 +422,10 @@ Configuration::StemmerCallback Configuration::getStemmer(ParserToken tok) const
 	});
 }
 
-void Configuration::setCustomStopwords(const StringView *w) { data->customStopwords = w; }
+void Configuration::setCustomStopwords(const StringView *w) {
+	data->customStopwords = w;
+	data->invalidateStemCache();
+}
 
 const StringView *Configuration::getCustomStopwords() const { return data->customStopwords; }
 
@@ -244,6 +434,23 @@ void Configuration::setPreStem(PreStemCallback &&cb) {
 }
 const Configuration::PreStemCallback &Configuration::getPreStem() const { return data->preStem; }
 
+void Configuration::setStemCacheSize(size_t size) {
+	if (size) {
+		size = size_t(math::npot(uint64_t(size)));
+	}
+	if (data->stemCacheSize == size) {
+		return;
+	}
+
+	data->stemCacheSize = size;
+	if (auto prev = data->stemCache.exchange(nullptr)) {
+		prev->retired = data->retiredStemCache;
+		data->retiredStemCache = prev;
+	}
+}
+
+size_t Configuration::getStemCacheSize() const { return data->stemCacheSize.load(); }
+
 void Configuration::stemPhrase(const StringView &str, const StemWordCallback &cb) const {
 	parsePhrase(str, [&, this](StringView word, ParserToken tok) {
 		if (data->preStem != nullptr && !isWordPart(tok)) {
@@ -335,6 +542,72 @@ size_t Configuration::makeSearchVector(SearchVector &vec, StringView str, Search
 	return counter;
 }
 
+size_t Configuration::stemDocuments(SearchVector &vec, SpanView<SearchData> docs,
+		thread::ThreadPool *threadPool, size_t counter) const {
+#if MODULE_STAPPLER_THREADS
+	if (threadPool && docs.size() > 1) {
+		struct Chunk {
+			SpanView<SearchData> docs;
+			memory::pool_t *pool = nullptr;
+			SearchVector *vec = nullptr;
+			size_t counter = 0;
+		};
+
+		// few chunks per worker to smooth out documents of different size
+		auto nchunks = std::min(size_t(threadPool->getInfo().threadCount + 1) * 4, docs.size());
+
+		Vector<Chunk> chunks;
+		chunks.reserve(nchunks);
+		for (size_t i = 0; i < nchunks; ++i) {
+			auto first = docs.size() * i / nchunks;
+			auto last = docs.size() * (i + 1) / nchunks;
+			chunks.emplace_back(Chunk{SpanView<SearchData>(docs, first, last - first)});
+		}
+
+		// every chunk uses its own root pool, so it does not depend on worker's pool lifetime
+		threadPool->performParallel(uint32_t(chunks.size()), 1,
+				[&, this](uint32_t first, uint32_t last) {
+			for (auto idx = first; idx < last; ++idx) {
+				auto &chunk = chunks[idx];
+				chunk.pool = memory::pool::create();
+				memory::perform([&, this] {
+					chunk.vec = new (memory::pool::palloc(chunk.pool, sizeof(SearchVector)))
+							SearchVector();
+					for (auto &it : chunk.docs) {
+						chunk.counter =
+								makeSearchVector(*chunk.vec, it.buffer, it.rank, chunk.counter);
+					}
+				}, chunk.pool);
+			}
+		});
+
+		// chunk positions starts from zero, shift them as if chunks were processed sequentially
+		for (auto &chunk : chunks) {
+			vec.documentLength += chunk.vec->documentLength;
+			for (auto &it : chunk.vec->words) {
+				auto wIt = vec.words.find(it.first);
+				if (wIt == vec.words.end()) {
+					wIt = vec.words
+								  .emplace(it.first.pdup(vec.words.get_allocator()),
+										  SearchVector::MatchVector())
+								  .first;
+				}
+				wIt->second.reserve(wIt->second.size() + it.second.size());
+				for (auto &pos : it.second) {
+					wIt->second.emplace_back(pos.first + counter, pos.second);
+				}
+			}
+			counter += chunk.counter;
+			memory::pool::destroy(chunk.pool);
+		}
+		return counter;
+	}
+#endif
+
+	for (auto &it : docs) { counter = makeSearchVector(vec, it.buffer, it.rank, counter); }
+	return counter;
+}
+
 String Configuration::encodeSearchVectorPostgres(const SearchVector &vec,
 		SearchData::Rank rank) const {
 	StringStream ret;
@@ -410,10 +683,47 @@ bool Configuration::stemWord(const StringView &word, ParserToken tok,
 	auto it = data->stemmers.find(tok);
 	if (it != data->stemmers.end()) {
 		return it->second(word, [&](StringView stem) { cb(word, stem, tok); });
-	} else {
-		return stemWordDefault(data->language, getEnvForToken(tok), tok, word,
-				[&](StringView stem) { cb(word, stem, tok); }, data->customStopwords);
 	}
+
+	auto cls = Configuration_getStemClass(tok);
+	if (cls && word.size() <= Configuration_StemCache::MaxWordSize) {
+		if (auto cache = data->getStemCache()) {
+			auto key = cache->makeKey(word, cls);
+
+			size_t size = 0;
+			char buf[Configuration_StemCache::MaxWordSize];
+			switch (cache->get(key, buf, size)) {
+			case Configuration_StemCache::Empty: break;
+			case Configuration_StemCache::Stopword: return false; break;
+			case Configuration_StemCache::Stemmed:
+				cb(word, StringView(buf, size), tok);
+				return true;
+				break;
+			}
+
+			// stemWordDefault calls callback at most once for word tokens
+			bool stemmed = false;
+			auto ret = stemWordDefault(data->language, getEnvForToken(tok), tok, word,
+					[&](StringView stem) {
+				if (stem.size() <= Configuration_StemCache::MaxWordSize) {
+					memcpy(buf, stem.data(), stem.size());
+					size = stem.size();
+					stemmed = true;
+				}
+				cb(word, stem, tok);
+			}, data->customStopwords);
+
+			if (!ret) {
+				cache->set(key, Configuration_StemCache::Stopword, StringView());
+			} else if (stemmed) {
+				cache->set(key, Configuration_StemCache::Stemmed, StringView(buf, size));
+			}
+			return ret;
+		}
+	}
+
+	return stemWordDefault(data->language, getEnvForToken(tok), tok, word,
+			[&](StringView stem) { cb(word, stem, tok); }, data->customStopwords);
 }
 
 StemmerEnv *Configuration::getEnvForToken(ParserToken tok) const {
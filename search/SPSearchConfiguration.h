@@ -26,6 +26,12 @@ THE SOFTWARE.
 
 #include "SPSearchQuery.h"
 
+namespace STAPPLER_VERSIONIZED stappler::thread {
+
+class ThreadPool;
+
+}
+
 namespace STAPPLER_VERSIONIZED stappler::search {
 
 class SP_PUBLIC Configuration : public memory::AllocPool {
@@ -72,6 +78,12 @@ public:
 	void setPreStem(PreStemCallback &&);
 	const PreStemCallback &getPreStem() const;
 
+	// Number of slots in word->stem cache for default stemmers, rounded up to power of two; 0 disables cache
+	// Safe to call while other threads stem words, but previous cache is freed only with configuration,
+	// so size should be set once, before configuration is used
+	void setStemCacheSize(size_t);
+	size_t getStemCacheSize() const;
+
 	void stemPhrase(const StringView &, const StemWordCallback &) const;
 	void stemHtml(const StringView &, const StemWordCallback &) const;
 
@@ -89,6 +101,11 @@ public:
 	size_t makeSearchVector(SearchVector &, StringView phrase, SearchData::Rank rank = SearchData::Rank::Unknown, size_t counter = 0,
 			const Callback<void(StringView, StringView, ParserToken)> & = nullptr) const;
 
+	// Same as makeSearchVector for every document in order (document's language is ignored);
+	// with thread pool, documents are stemmed in parallel, so custom stemmers and pre-stem callback should be thread-safe
+	size_t stemDocuments(SearchVector &, SpanView<SearchData>, thread::ThreadPool * = nullptr,
+			size_t counter = 0) const;
+
 	// encode for postgres textual representation
 	String encodeSearchVectorPostgres(const SearchVector &, SearchData::Rank rank = SearchData::Rank::Unknown) const;
 
@@ -101,6 +101,9 @@ public:
 	Distance() noexcept;
 	Distance(const StringView &origin, const StringView &canonical, size_t maxDistance = maxOf<size_t>());
 
+	// restore alignment from stored values (e.g. from SearchIndex snapshot)
+	Distance(Storage &&) noexcept;
+
 	Distance(const Distance &) noexcept;
 	Distance(Distance &&) noexcept;
 
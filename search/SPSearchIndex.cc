@@ -26,7 +26,35 @@ THE SOFTWARE.
 
 namespace STAPPLER_VERSIONIZED stappler::search {
 
+static constexpr uint64_t SearchIndex_SnapshotMagic = "SPSearchIndex"_hash64;
+static constexpr uint32_t SearchIndex_SnapshotVersion = 1;
+static constexpr uint32_t SearchIndex_SnapshotByteOrder = 0x0102'0304;
+
+// Snapshot layout: header, nodes, tokens, terms, terms data, canonical strings, alignments;
+// all sections are 8-byte aligned, values are in native byte order
+struct SearchIndex_SnapshotHeader {
+	uint64_t magic = SearchIndex_SnapshotMagic;
+	uint32_t version = SearchIndex_SnapshotVersion;
+	uint32_t byteOrder = SearchIndex_SnapshotByteOrder;
+	uint64_t dataVersion = 0;
+	uint64_t checksum = 0; // xxh64 of everything after the header
+	uint64_t size = 0; // full snapshot size, including header
+	uint32_t nodes = 0;
+	uint32_t tokens = 0;
+	uint32_t terms = 0; // including sentinel
+	uint32_t reserved = 0;
+	uint64_t tokensOffset = 0;
+	uint64_t termsOffset = 0;
+	uint64_t termsDataOffset = 0;
+	uint64_t termsDataSize = 0;
+	uint64_t stringsOffset = 0;
+	uint64_t stringsSize = 0;
+	uint64_t alignmentsOffset = 0;
+	uint64_t alignmentsSize = 0;
+};
+
 bool SearchIndex::init(const TokenizerCallback &tcb) {
+	_pool = memory::pool::acquire();
 	_tokenizer = tcb;
 	return true;
 }
@@ -36,13 +64,16 @@ void SearchIndex::reserve(size_t s) {
 }
 
 void SearchIndex::add(const StringView &v, int64_t id, int64_t tag) {
-	String origin(string::tolower<Interface>(v));
+	if (_mapping) {
+		log::source().error("search", "SearchIndex: fail to add node: index, loaded from snapshot, is read-only");
+		return;
+	}
 
-	_nodes.emplace_back(Node{id, tag});
+	String origin(string::tolower<Interface>(v));
+	String canonical;
 
-	Node &node = _nodes.back();
-	uint32_t idx = uint32_t(_nodes.size() - 1);
-	auto &canonical = node.canonical;
+	uint32_t idx = uint32_t(_nodes.size());
+	auto tokensCount = _tokens.size();
 
 	auto tokenFn = [&, this] (const StringView &str) {
 		if (!str.empty()) {
@@ -50,8 +81,8 @@ void SearchIndex::add(const StringView &v, int64_t id, int64_t tag) {
 				canonical.append(" ");
 			}
 			auto s = canonical.size();
-			canonical.append(str.str<Interface>());
-			onToken(_tokens, str, idx, Slice{ uint16_t(s), uint16_t(str.size()) });
+			canonical.append(str.data(), str.size());
+			_tokens.emplace_back(Token{idx, Slice{ uint16_t(s), uint16_t(str.size()) }});
 		}
 	};
 
@@ -63,46 +94,315 @@ void SearchIndex::add(const StringView &v, int64_t id, int64_t tag) {
 	}
 
 	if (canonical.empty()) {
-		_nodes.pop_back();
-	} else if (canonical != origin) {
+		_tokens.resize(tokensCount);
+		return;
+	}
+
+	auto &node = _nodes.emplace_back(Node{id, tag, StringView(canonical).pdup(_pool)});
+	if (canonical != origin) {
 		node.alignment = Distance(origin, canonical);
 	}
 }
 
+void SearchIndex::freeze() {
+	if (isFrozen()) {
+		return;
+	}
+
+	auto less = [this] (const Token &l, const Token &r) {
+		auto ret = string::detail::compare_c(makeStringView(l), makeStringView(r));
+		if (ret != 0) {
+			return ret < 0;
+		}
+		return (l.index != r.index) ? l.index < r.index : l.slice.start < r.slice.start;
+	};
+
+	// new tokens are sorted once, then merged with sorted part in linear time
+	auto mid = _tokens.begin() + _sortedTokens;
+	std::sort(mid, _tokens.end(), less);
+	std::inplace_merge(_tokens.begin(), mid, _tokens.end(), less);
+	_sortedTokens = _tokens.size();
+
+	_terms.clear();
+	_termsData.clear();
+
+	StringView prev;
+	for (uint32_t i = 0; i < uint32_t(_tokens.size()); ++i) {
+		auto str = makeStringView(_tokens[i]);
+		if (_terms.empty() || str != prev) {
+			_terms.emplace_back(Term{uint32_t(_termsData.size()), uint32_t(str.size()), i});
+			_termsData.append(str.data(), str.size());
+			prev = str;
+		}
+	}
+
+	_terms.emplace_back(Term{uint32_t(_termsData.size()), 0, uint32_t(_tokens.size())});
+	_terms.shrink_to_fit();
+	_termsData.shrink_to_fit();
+}
+
+bool SearchIndex::save(const FileInfo &info, uint64_t dataVersion) {
+	freeze();
+
+	auto align = [] (uint64_t val) { return math::align<uint64_t>(val, 8); };
+
+	SearchIndex_SnapshotHeader header;
+	header.dataVersion = dataVersion;
+	header.nodes = uint32_t(getNodesCount());
+	auto tokens = getTokens();
+	auto terms = getTerms();
+	auto termsData = getTermsData();
+
+	header.tokens = uint32_t(tokens.size());
+	header.terms = uint32_t(terms.size());
+
+	if (_mapping) {
+		header.stringsSize = _snapshotStrings.size();
+		header.alignmentsSize = _snapshotAlignments.size();
+	} else {
+		for (auto &it : _nodes) {
+			header.stringsSize += it.canonical.size();
+			header.alignmentsSize += it.alignment.size();
+		}
+	}
+
+	header.tokensOffset = align(sizeof(SearchIndex_SnapshotHeader) + sizeof(SnapshotNode) * header.nodes);
+	header.termsOffset = align(header.tokensOffset + sizeof(Token) * header.tokens);
+	header.termsDataOffset = align(header.termsOffset + sizeof(Term) * header.terms);
+	header.termsDataSize = termsData.size();
+	header.stringsOffset = align(header.termsDataOffset + header.termsDataSize);
+	header.alignmentsOffset = align(header.stringsOffset + header.stringsSize);
+	header.size = align(header.alignmentsOffset + header.alignmentsSize);
+
+	if (header.stringsSize > maxOf<uint32_t>() || header.alignmentsSize > maxOf<uint32_t>()) {
+		log::source().error("search", "SearchIndex: index is too large for snapshot");
+		return false;
+	}
+
+	bool ret = false;
+	auto pool = memory::pool::create(memory::pool::acquire());
+	memory::perform([&] {
+		Bytes data;
+		data.resize(header.size, 0);
+
+		auto nodes = reinterpret_cast<SnapshotNode *>(data.data() + sizeof(SearchIndex_SnapshotHeader));
+		auto strings = data.data() + header.stringsOffset;
+		auto alignments = data.data() + header.alignmentsOffset;
+
+		uint32_t stringsOffset = 0;
+		uint32_t alignmentsOffset = 0;
+		if (_mapping) {
+			// snapshot sections are copied as is
+			memcpy(nodes, _snapshotNodes.data(), sizeof(SnapshotNode) * header.nodes);
+			memcpy(strings, _snapshotStrings.data(), _snapshotStrings.size());
+			memcpy(alignments, _snapshotAlignments.data(), _snapshotAlignments.size());
+		}
+
+		for (auto &it : _nodes) {
+			auto alignmentSize = uint32_t(it.alignment.size());
+			*nodes++ = SnapshotNode{it.id, it.tag, stringsOffset, uint32_t(it.canonical.size()),
+				alignmentsOffset, alignmentSize};
+
+			memcpy(strings + stringsOffset, it.canonical.data(), it.canonical.size());
+			stringsOffset += it.canonical.size();
+
+			if (alignmentSize > 0) {
+				auto storage = it.alignment.storage();
+				for (uint32_t i = 0; i < alignmentSize; ++ i) {
+					alignments[alignmentsOffset + i] = toInt(storage.at(i));
+				}
+				alignmentsOffset += alignmentSize;
+			}
+		}
+
+		if (!tokens.empty()) {
+			memcpy(data.data() + header.tokensOffset, tokens.data(), sizeof(Token) * header.tokens);
+		}
+		if (!terms.empty()) {
+			memcpy(data.data() + header.termsOffset, terms.data(), sizeof(Term) * header.terms);
+		}
+		if (!termsData.empty()) {
+			memcpy(data.data() + header.termsDataOffset, termsData.data(), header.termsDataSize);
+		}
+
+		header.checksum = hash::hash64((const char *)data.data() + sizeof(SearchIndex_SnapshotHeader),
+				data.size() - sizeof(SearchIndex_SnapshotHeader));
+		memcpy(data.data(), &header, sizeof(SearchIndex_SnapshotHeader));
+
+		// write into temporary file, then replace snapshot, so mapped snapshots remain valid
+		auto tmpPath = string::toString<Interface>(info.path, ".tmp");
+		FileInfo tmpInfo(tmpPath, info.category, info.flags);
+		if (!filesystem::write(tmpInfo, data)) {
+			log::source().error("search", "SearchIndex: fail to write snapshot: ", tmpInfo);
+			return;
+		}
+
+		if (!filesystem::move(tmpInfo, info)) {
+			log::source().error("search", "SearchIndex: fail to write snapshot: ", info);
+			filesystem::remove(tmpInfo);
+			return;
+		}
+
+		ret = true;
+	}, pool);
+	memory::pool::destroy(pool);
+	return ret;
+}
+
+bool SearchIndex::load(const FileInfo &info, uint64_t dataVersion, bool verifyChecksum) {
+	if (!_nodes.empty() || _mapping) {
+		log::source().error("search", "SearchIndex: snapshot can only be loaded into empty index");
+		return false;
+	}
+
+	auto region = filesystem::MemoryMappedRegion::mapFile(info, filesystem::MappingType::Private,
+			filesystem::ProtFlags::MapRead);
+	if (!region) {
+		log::source().error("search", "SearchIndex: fail to map snapshot: ", info);
+		return false;
+	}
+
+	auto data = region.getView();
+
+	SearchIndex_SnapshotHeader header;
+	if (data.size() < sizeof(SearchIndex_SnapshotHeader)) {
+		log::source().error("search", "SearchIndex: invalid snapshot: ", info);
+		return false;
+	}
+
+	memcpy(&header, data.data(), sizeof(SearchIndex_SnapshotHeader));
+
+	if (header.magic != SearchIndex_SnapshotMagic || header.byteOrder != SearchIndex_SnapshotByteOrder
+			|| header.version != SearchIndex_SnapshotVersion) {
+		log::source().error("search", "SearchIndex: invalid snapshot format: ", info);
+		return false;
+	}
+
+	if (header.dataVersion != dataVersion) {
+		log::source().error("search", "SearchIndex: stale snapshot: ", info, " (", header.dataVersion,
+				" != ", dataVersion, ")");
+		return false;
+	}
+
+	auto isValidSection = [&] (uint64_t offset, uint64_t size) {
+		return offset % 8 == 0 && offset <= header.size && size <= header.size - offset;
+	};
+
+	if (header.size != data.size() || header.terms == 0
+			|| !isValidSection(sizeof(SearchIndex_SnapshotHeader), sizeof(SnapshotNode) * uint64_t(header.nodes))
+			|| !isValidSection(header.tokensOffset, sizeof(Token) * uint64_t(header.tokens))
+			|| !isValidSection(header.termsOffset, sizeof(Term) * uint64_t(header.terms))
+			|| !isValidSection(header.termsDataOffset, header.termsDataSize)
+			|| !isValidSection(header.stringsOffset, header.stringsSize)
+			|| !isValidSection(header.alignmentsOffset, header.alignmentsSize)) {
+		log::source().error("search", "SearchIndex: corrupted snapshot: ", info);
+		return false;
+	}
+
+	if (verifyChecksum && hash::hash64((const char *)data.data() + sizeof(SearchIndex_SnapshotHeader),
+			data.size() - sizeof(SearchIndex_SnapshotHeader)) != header.checksum) {
+		log::source().error("search", "SearchIndex: snapshot checksum mismatch: ", info);
+		return false;
+	}
+
+	auto tokens = SpanView<Token>(reinterpret_cast<const Token *>(data.data() + header.tokensOffset), header.tokens);
+	auto terms = SpanView<Term>(reinterpret_cast<const Term *>(data.data() + header.termsOffset), header.terms);
+
+	auto nodes = SpanView<SnapshotNode>(reinterpret_cast<const SnapshotNode *>(data.data() + sizeof(SearchIndex_SnapshotHeader)), header.nodes);
+	auto termsData = StringView(reinterpret_cast<const char *>(data.data() + header.termsDataOffset), header.termsDataSize);
+
+	// all offsets are checked once, so snapshot can be queried without bounds checks
+	auto isValidData = [&] {
+		for (auto &node : nodes) {
+			if (uint64_t(node.canonical) + node.canonicalSize > header.stringsSize
+					|| uint64_t(node.alignment) + node.alignmentSize > header.alignmentsSize) {
+				return false;
+			}
+		}
+
+		for (auto &it : tokens) {
+			if (it.index >= header.nodes
+					|| uint32_t(it.slice.start) + it.slice.size > nodes[it.index].canonicalSize) {
+				return false;
+			}
+		}
+
+		// terms should be sorted and should cover all tokens, sentinel term is at the end
+		StringView prev;
+		for (size_t i = 0; i < terms.size(); ++ i) {
+			auto &term = terms[i];
+			if (uint64_t(term.start) + term.size > header.termsDataSize || term.tokens > header.tokens
+					|| (i == 0 && term.tokens != 0) || (i > 0 && term.tokens < terms[i - 1].tokens)) {
+				return false;
+			}
+
+			if (i + 1 < terms.size()) {
+				auto str = StringView(termsData.data() + term.start, term.size);
+				if (i > 0 && string::detail::compare_c(prev, str) >= 0) {
+					return false;
+				}
+				prev = str;
+			}
+		}
+
+		return terms.back().tokens == header.tokens;
+	};
+
+	if (!isValidData()) {
+		log::source().error("search", "SearchIndex: corrupted snapshot: ", info);
+		return false;
+	}
+
+	_tokensView = tokens;
+	_termsView = terms;
+	_termsDataView = termsData;
+
+	_snapshotNodes = nodes;
+	_snapshotStrings = StringView(reinterpret_cast<const char *>(data.data() + header.stringsOffset), header.stringsSize);
+	_snapshotAlignments = BytesView(data.data() + header.alignmentsOffset, header.alignmentsSize);
+
+	// mapping is moved without remapping, so views remain valid
+	_mapping.emplace(move(region));
+	return true;
+}
+
 SearchIndex::Result SearchIndex::performSearch(const StringView &v, size_t minMatch, const HeuristicCallback &cb,
-		const FilterCallback & filter) {
+		const FilterCallback & filter, uint32_t maxDistance, size_t maxResults) {
 	String origin(string::tolower<Interface>(v));
 
 	SearchIndex::Result res{this};
 
 	uint32_t wordIndex = 0;
 
+	sprt_passert(isFrozen(), "SearchIndex should be frozen before search");
+
+	auto tokens = getTokens();
+	auto terms = getTerms();
+
+	// matches are collected in flat array, then grouped by node with single sort
+	struct Match {
+		uint32_t node;
+		ResultToken token;
+	};
+
+	Vector<Match> matches;
+
+	auto addTerm = [&, this] (const Term &term, uint16_t match, uint16_t distance) {
+		for (auto i = term.tokens; i < (&term + 1)->tokens; ++ i) {
+			auto &token = tokens[i];
+			matches.emplace_back(Match{token.index, ResultToken{wordIndex, match, token.slice, distance}});
+		}
+	};
+
 	auto tokenFn = [&, this] (const StringView &str) {
-		auto lb = std::lower_bound(_tokens.begin(), _tokens.end(), str, [&, this] (const Token &l, const StringView &r) {
-			return string::detail::compare_c(makeStringView(l.index, l.slice), r) < 0;
-		});
-
-		if (lb != _tokens.end()) {
-			auto node = &_nodes.at(lb->index);
-			StringView value = makeStringView(*lb);
-
-			while (lb != _tokens.end() && value.size() >= str.size() && String::traits_type::compare(value.data(), str.data(), str.size()) == 0) {
-				if (!filter || filter(node)) {
-					auto ret_it = std::lower_bound(res.nodes.begin(), res.nodes.end(), node,
-							[&] (const ResultNode &l, const Node *r) {
-						return l.node < r;
-					});
-					if (ret_it == res.nodes.end() || ret_it->node != node) {
-						res.nodes.emplace(ret_it, ResultNode{ 0.0f, node, {ResultToken{wordIndex, uint16_t(str.size()), lb->slice}} });
-					} else {
-						ret_it->matches.emplace_back(ResultToken{wordIndex, uint16_t(str.size()), lb->slice});
-					}
-				}
-				++ lb;
-				if (lb != _tokens.end()) {
-					value = makeStringView(*lb);
-					node = &_nodes.at(lb->index);
-				}
+		if (maxDistance > 0) {
+			findFuzzyTerms(str, maxDistance, addTerm);
+		} else {
+			auto term = findTerm(str);
+			auto termsEnd = term ? terms.data() + terms.size() - 1 : nullptr;
+			while (term != termsEnd && makeStringView(*term).starts_with(str)) {
+				addTerm(*term, uint16_t(str.size()), 0);
+				++ term;
 			}
 		}
 		wordIndex ++;
@@ -115,14 +415,63 @@ SearchIndex::Result SearchIndex::performSearch(const StringView &v, size_t minMa
 		r.split<DefaultSep>(tokenFn);
 	}
 
+	// stable to preserve order of request words within node
+	std::stable_sort(matches.begin(), matches.end(), [] (const Match &l, const Match &r) {
+		return l.node < r.node;
+	});
+
+	auto scoreLess = [] (const ResultNode &l, const ResultNode &r) {
+		return l.score > r.score;
+	};
+
+	// with maxResults and heuristic, only best nodes are kept in min-heap by score
+	bool useHeap = cb && maxResults > 0;
+	ResultNode scratch;
+
+	auto it = matches.begin();
+	while (it != matches.end()) {
+		auto groupEnd = it;
+		while (groupEnd != matches.end() && groupEnd->node == it->node) {
+			++ groupEnd;
+		}
+
+		auto node = getNode(it->node);
+		if (!filter || filter(node)) {
+			scratch.node = node;
+			scratch.matches.clear();
+			for (auto m = it; m != groupEnd; ++ m) {
+				scratch.matches.emplace_back(m->token);
+			}
+
+			if (!useHeap) {
+				res.nodes.emplace_back(move(scratch));
+				if (!cb && maxResults > 0 && res.nodes.size() >= maxResults) {
+					break;
+				}
+			} else {
+				scratch.score = cb(*this, scratch);
+				if (res.nodes.size() < maxResults) {
+					res.nodes.emplace_back(move(scratch));
+					std::push_heap(res.nodes.begin(), res.nodes.end(), scoreLess);
+				} else if (scratch.score > res.nodes.front().score) {
+					std::pop_heap(res.nodes.begin(), res.nodes.end(), scoreLess);
+					std::swap(res.nodes.back(), scratch);
+					std::push_heap(res.nodes.begin(), res.nodes.end(), scoreLess);
+				}
+			}
+		}
+
+		it = groupEnd;
+	}
+
 	if (cb) {
-		for (auto &it : res.nodes) {
-			it.score = cb(*this, it);
+		if (!useHeap) {
+			for (auto &n : res.nodes) {
+				n.score = cb(*this, n);
+			}
 		}
 
-		std::sort(res.nodes.begin(), res.nodes.end(), [] (const ResultNode &l, const ResultNode &r) {
-			return l.score > r.score;
-		});
+		std::sort(res.nodes.begin(), res.nodes.end(), scoreLess);
 	}
 
 	return res;
@@ -144,28 +493,193 @@ SearchIndex::Slice SearchIndex::convertToken(const Node &node, const ResultToken
 }
 
 void SearchIndex::print(const Callback<void(StringView)> &out) const {
-	for (auto &it : _tokens) {
-		out << it.index << " " << makeStringView(it) << " " << _nodes.at(it.index).id << "\n";
+	// tokens, that are not frozen yet, are printed after sorted ones
+	auto tokens = _mapping ? _tokensView : SpanView<Token>(_tokens);
+	for (auto &it : tokens) {
+		out << it.index << " " << makeStringView(it) << " "
+			<< (_mapping ? _snapshotNodes[it.index].id : _nodes.at(it.index).id) << "\n";
 	}
 }
 
+size_t SearchIndex::getNodesCount() const {
+	return _mapping ? _snapshotNodes.size() : _nodes.size();
+}
+
+StringView SearchIndex::getCanonical(uint32_t idx) const {
+	if (_mapping) {
+		auto &node = _snapshotNodes[idx];
+		return StringView(_snapshotStrings.data() + node.canonical, node.canonicalSize);
+	}
+	return _nodes[idx].canonical;
+}
+
+auto SearchIndex::getTokens() const -> SpanView<Token> {
+	// tokens, added after last freeze, are not part of dictionary
+	return _mapping ? _tokensView : SpanView<Token>(_tokens.data(), _sortedTokens);
+}
+
+auto SearchIndex::getTerms() const -> SpanView<Term> {
+	return _mapping ? _termsView : SpanView<Term>(_terms);
+}
+
+StringView SearchIndex::getTermsData() const {
+	return _mapping ? _termsDataView : StringView(_termsData);
+}
+
+const SearchIndex::Node *SearchIndex::getNode(uint32_t idx) const {
+	if (!_mapping) {
+		return &_nodes[idx];
+	}
+
+	auto &node = _snapshotNodes[idx];
+
+	Distance::Storage storage;
+	if (node.alignmentSize > 0) {
+		storage.reserve(node.alignmentSize);
+		for (uint32_t j = 0; j < node.alignmentSize; ++ j) {
+			storage.emplace_back(Distance::Value(_snapshotAlignments[node.alignment + j] & 0x3));
+		}
+	}
+
+	return new (memory::pool::palloc(memory::pool::acquire(), sizeof(Node))) Node{node.id, node.tag,
+		StringView(_snapshotStrings.data() + node.canonical, node.canonicalSize), Distance(move(storage))};
+}
+
 StringView SearchIndex::makeStringView(const Token &t) const {
 	return makeStringView(t.index, t.slice);
 }
 
 StringView SearchIndex::makeStringView(uint32_t idx, const Slice &sl) const {
-	const Node &node = _nodes.at(idx);
-	return StringView(node.canonical.data() + sl.start, sl.size);
+	return StringView(getCanonical(idx).data() + sl.start, sl.size);
+}
+
+StringView SearchIndex::makeStringView(const Term &t) const {
+	return StringView(getTermsData().data() + t.start, t.size);
 }
 
-void SearchIndex::onToken(Vector<Token> &vec, const StringView &rep, uint32_t idx, const Slice &sl) {
-	auto insert_it = std::lower_bound(vec.begin(), vec.end(), rep, [&, this] (const Token &l, const StringView &r) {
-		return string::detail::compare_c(makeStringView(l.index, l.slice), r) < 0;
+auto SearchIndex::findTerm(StringView prefix) const -> const Term * {
+	auto terms = getTerms();
+	if (terms.empty()) {
+		return nullptr;
+	}
+
+	auto end = terms.data() + terms.size() - 1;
+	return std::lower_bound(terms.data(), end, prefix, [&, this] (const Term &l, const StringView &r) {
+		return string::detail::compare_c(makeStringView(l), r) < 0;
 	});
-	if (insert_it ==  vec.end()) {
-		vec.emplace_back(Token{idx, sl});
-	} else {
-		vec.emplace(insert_it, Token{idx, sl});
+}
+
+void SearchIndex::findFuzzyTerms(StringView word, uint32_t maxDistance,
+		const Callback<void(const Term &, uint16_t match, uint16_t distance)> &cb) const {
+	auto terms = getTerms();
+	if (terms.size() <= 1 || word.empty()) {
+		return;
+	}
+
+	Vector<char32_t> query;
+	uint8_t offset = 0;
+	while (!word.empty()) {
+		query.emplace_back(sprt::unicode::utf8Decode32(word.data(), word.size(), offset));
+		word += offset;
+	}
+
+	const size_t n = query.size();
+	const uint32_t k = std::min(maxDistance, uint32_t(n - 1));
+
+	// For term's char depth d: row d of Levenshtein matrix between request word and term prefix,
+	// byte offset of prefix, best distance for full word within prefix and its length
+	Vector<uint32_t> rows;
+	Vector<uint32_t> offsets;
+	Vector<uint32_t> bestDistance;
+	Vector<uint32_t> bestMatch;
+
+	rows.resize(n + 1);
+	for (size_t j = 0; j <= n; ++ j) {
+		rows[j] = uint32_t(j);
+	}
+	offsets.emplace_back(0);
+	bestDistance.emplace_back(uint32_t(n));
+	bestMatch.emplace_back(0);
+
+	auto end = terms.data() + terms.size() - 1;
+	auto term = terms.data();
+
+	StringView prev;
+	size_t validDepth = 0;
+
+	while (term < end) {
+		auto str = makeStringView(*term);
+
+		// rows for common prefix with previous term are reused
+		size_t lcp = 0;
+		while (lcp < prev.size() && lcp < str.size() && prev[lcp] == str[lcp]) {
+			++ lcp;
+		}
+
+		size_t depth = 0;
+		while (depth < validDepth && offsets[depth + 1] <= lcp) {
+			++ depth;
+		}
+
+		bool pruned = false;
+		while (offsets[depth] < str.size()) {
+			auto c = sprt::unicode::utf8Decode32(str.data() + offsets[depth], str.size() - offsets[depth], offset);
+
+			if (rows.size() < (depth + 2) * (n + 1)) {
+				rows.resize((depth + 2) * (n + 1));
+				offsets.resize(depth + 2);
+				bestDistance.resize(depth + 2);
+				bestMatch.resize(depth + 2);
+			}
+
+			auto prevRow = rows.data() + depth * (n + 1);
+			auto row = prevRow + (n + 1);
+
+			row[0] = uint32_t(depth + 1);
+			auto rowMin = row[0];
+			for (size_t j = 1; j <= n; ++ j) {
+				row[j] = std::min(std::min(prevRow[j], row[j - 1]) + 1, prevRow[j - 1] + ((query[j - 1] == c) ? 0 : 1));
+				rowMin = std::min(rowMin, row[j]);
+			}
+
+			offsets[depth + 1] = offsets[depth] + offset;
+			if (row[n] < bestDistance[depth]) {
+				bestDistance[depth + 1] = row[n];
+				bestMatch[depth + 1] = offsets[depth + 1];
+			} else {
+				bestDistance[depth + 1] = bestDistance[depth];
+				bestMatch[depth + 1] = bestMatch[depth];
+			}
+
+			++ depth;
+
+			if (rowMin > k) {
+				// no term with this prefix can be closer then already found
+				pruned = true;
+				break;
+			}
+		}
+
+		validDepth = depth;
+		prev = str;
+
+		if (pruned) {
+			auto prefix = str.sub(0, offsets[depth]);
+			auto next = std::partition_point(term, end, [&, this] (const Term &t) {
+				return makeStringView(t).starts_with(prefix);
+			});
+			if (bestDistance[depth] <= k) {
+				for (; term != next; ++ term) {
+					cb(*term, uint16_t(bestMatch[depth]), uint16_t(bestDistance[depth]));
+				}
+			}
+			term = next;
+		} else {
+			if (bestDistance[depth] <= k) {
+				cb(*term, uint16_t(bestMatch[depth]), uint16_t(bestDistance[depth]));
+			}
+			++ term;
+		}
 	}
 }
 
@@ -188,12 +702,18 @@ float SearchIndex::Heuristic::operator () (const SearchIndex &index, const Searc
 			}
 		}
 
+		float tokenScore = 0.0f;
 		if (token_it.match == token_it.slice.size) {
-			score += mod * fullMatchCost;
+			tokenScore += fullMatchCost;
+		}
+
+		tokenScore += wordScore(token_it.match, token_it.slice.size);
+		tokenScore += positionScore(idx, token_it.word);
+		if (token_it.distance > 0) {
+			tokenScore *= distancePenalty(token_it.distance, token_it.match);
 		}
 
-		score += mod * wordScore(token_it.match, token_it.slice.size);
-		score += mod * positionScore(idx, token_it.word);
+		score += mod * tokenScore;
 		idx = token_it.word;
 	}
 	return score;
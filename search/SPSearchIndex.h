@@ -25,6 +25,7 @@ THE SOFTWARE.
 #define STAPPLER_SEARCH_SPSEARCHINDEX_H_
 
 #include "SPRef.h"
+#include "SPFilesystem.h"
 #include "SPSearchDistance.h"
 
 namespace STAPPLER_VERSIONIZED stappler::search {
@@ -61,7 +62,7 @@ public:
 	struct Node {
 		int64_t id = 0;
 		int64_t tag = 0;
-		String canonical;
+		StringView canonical; // allocated from index pool
 		Distance alignment;
 	};
 
@@ -70,10 +71,18 @@ public:
 		Slice slice; // slice from canonical
 	};
 
+	// Unique token string in frozen dictionary, terms are sorted by string
+	struct Term {
+		uint32_t start = 0; // offset in terms string data
+		uint32_t size = 0; // string length
+		uint32_t tokens = 0; // first token in sorted tokens, range ends on next term's first token
+	};
+
 	struct ResultToken {
 		uint32_t word = 0; // node index
 		uint16_t match = 0; // node index
 		Slice slice; // slice from canonical
+		uint16_t distance = 0; // edit distance from request word to matched part (in chars)
 	};
 
 	struct ResultNode {
@@ -118,15 +127,46 @@ public:
 			}
 			return 0.0f;
 		};
+
+		// token score is multiplied by penalty for fuzzy matches
+		SizeCallback distancePenalty = [] (uint32_t distance, uint32_t match) -> float {
+			return 1.0f / float(1 + distance);
+		};
 	};
 
 	bool init(const TokenizerCallback & = nullptr);
 
 	void reserve(size_t);
+
+	// Adds node without sorting, tokens are merged into dictionary on next freeze()
 	void add(const StringView &, int64_t id, int64_t tag);
 
+	// Sorts tokens, added since last call, merges them with dictionary and rebuilds terms
+	// Should be called after nodes are added and before searches; nodes, added after last
+	// freeze(), are not visible for searches
+	void freeze();
+
+	bool isFrozen() const { return _sortedTokens == _tokens.size(); }
+
+	// Snapshot contains nodes and frozen dictionary of the index, it can be mapped into memory
+	// with load() and queried in place; dataVersion is stored in snapshot as is, load fails
+	// if it's not matched (use it to detect stale snapshots)
+	bool save(const FileInfo &, uint64_t dataVersion = 0);
+
+	// Index should be empty; after loading it's read-only and queried directly in mapped
+	// snapshot: Node objects are created only for nodes in search results
+	// All offsets of snapshot are validated, so corrupted file is rejected even without checksum
+	bool load(const FileInfo &, uint64_t dataVersion = 0, bool verifyChecksum = true);
+
+	bool isMapped() const { return _mapping.has_value(); }
+
+	// Search does not modify index, so concurrent searches are safe; index should be frozen
+	// (or loaded from snapshot) before search
+	// With maxDistance > 0, request words also match tokens with prefix within maxDistance edits
+	// (Levenshtein distance in unicode chars, limited to word length - 1)
+	// With maxResults > 0, only best maxResults nodes are returned
 	Result performSearch(const StringView &, size_t minMatch, const HeuristicCallback & = Heuristic(),
-			const FilterCallback & filter = nullptr);
+			const FilterCallback & filter = nullptr, uint32_t maxDistance = 0, size_t maxResults = 0);
 
 	StringView resolveToken(const Node &, const ResultToken &) const;
 	Slice convertToken(const Node &, const ResultToken &) const;
@@ -134,13 +174,57 @@ public:
 	void print(const Callback<void(StringView)> &out) const;
 
 protected:
+	// node, stored in snapshot; canonical string and alignment are in separate sections
+	struct SnapshotNode {
+		int64_t id;
+		int64_t tag;
+		uint32_t canonical; // offset in strings section
+		uint32_t canonicalSize;
+		uint32_t alignment; // offset in alignments section, one byte per value
+		uint32_t alignmentSize;
+	};
+
+	size_t getNodesCount() const;
+	StringView getCanonical(uint32_t idx) const;
+
+	// frozen dictionary: sorted part of _tokens with terms, or sections of mapped snapshot
+	SpanView<Token> getTokens() const;
+	SpanView<Term> getTerms() const;
+	StringView getTermsData() const;
+
+	// for mapped snapshot, node is created from snapshot data in current pool
+	const Node *getNode(uint32_t idx) const;
+
 	StringView makeStringView(const Token &) const;
 	StringView makeStringView(uint32_t idx, const Slice &) const;
+	StringView makeStringView(const Term &) const;
 
-	void onToken(Vector<Token> &vec, const StringView &, uint32_t, const Slice &);
+	// returns first term, that starts with prefix, or end of terms
+	const Term *findTerm(StringView prefix) const;
 
+	// calls callback for every term with prefix within maxDistance edits from word; terms are
+	// walked in order as trie paths, sharing rows of Levenshtein matrix for common prefixes
+	void findFuzzyTerms(StringView word, uint32_t maxDistance,
+			const Callback<void(const Term &, uint16_t match, uint16_t distance)> &) const;
+
+	memory::pool_t *_pool = nullptr;
 	Vector<Node> _nodes;
-	Vector<Token> _tokens;
+	Vector<Token> _tokens; // sorted up to _sortedTokens
+	size_t _sortedTokens = 0;
+	Vector<Term> _terms; // with sentinel term at the end
+	String _termsData;
+
+	// frozen dictionary of mapped snapshot
+	SpanView<Token> _tokensView;
+	SpanView<Term> _termsView;
+	StringView _termsDataView;
+
+	// nodes of mapped snapshot
+	SpanView<SnapshotNode> _snapshotNodes;
+	StringView _snapshotStrings;
+	BytesView _snapshotAlignments;
+	std::optional<filesystem::MemoryMappedRegion> _mapping;
+
 	TokenizerCallback _tokenizer;
 };
 
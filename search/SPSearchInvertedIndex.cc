@@ -0,0 +1,697 @@
+/**
+ Copyright (c) 2025 Stappler LLC <admin@stappler.dev>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ **/
+
+
+#include "SPSearchInvertedIndex.h"
+
+namespace STAPPLER_VERSIONIZED stappler::search {
+
+// Posting list for term is a sequence of entries for documents, sorted by document index:
+// varint(document delta), varint(positions count), varint(positions size in bytes),
+// then positions: varint(position delta << 3 | rank)
+
+struct InvertedIndex::Segment : memory::AllocPool {
+	struct Term {
+		uint32_t start = 0; // offset in terms data
+		uint32_t size = 0;
+		uint32_t docs = 0; // number of documents with term
+		uint32_t postingsSize = 0;
+		uint64_t postings = 0; // offset in postings data
+	};
+
+	memory::pool_t *pool = nullptr;
+	Vector<int64_t> ids;
+	Vector<uint32_t> lengths;
+	Vector<Term> terms; // sorted by string
+	String termsData;
+	Bytes postings;
+
+	StringView getTerm(const Term &t) const { return StringView(termsData.data() + t.start, t.size); }
+
+	const Term *findTerm(StringView str) const {
+		auto it = std::lower_bound(terms.begin(), terms.end(), str,
+				[&, this](const Term &l, const StringView &r) { return getTerm(l) < r; });
+		if (it != terms.end() && getTerm(*it) == str) {
+			return &(*it);
+		}
+		return nullptr;
+	}
+};
+
+struct InvertedIndex::Buffer : memory::AllocPool {
+	struct Postings {
+		uint32_t docs = 0;
+		uint32_t last = 0;
+		Bytes data;
+	};
+
+	memory::pool_t *pool = nullptr;
+	Vector<int64_t> ids;
+	Vector<uint32_t> lengths;
+	Map<StringView, Postings> terms;
+};
+
+struct InvertedIndex_DocSet {
+	Vector<uint32_t> docs;
+	bool complement = false; // set contains all documents, except listed
+};
+
+template <typename T>
+static T *InvertedIndex_create(memory::pool_t *parent) {
+	auto pool = memory::pool::create(parent);
+	T *ret = nullptr;
+	memory::perform([&] {
+		ret = new (pool) T();
+		ret->pool = pool;
+	}, pool);
+	return ret;
+}
+
+template <typename T>
+static void InvertedIndex_destroy(T *obj) {
+	auto pool = obj->pool;
+	obj->~T();
+	memory::pool::destroy(pool);
+}
+
+static void InvertedIndex_writeVarint(Bytes &out, uint64_t value) {
+	while (value >= 0x80) {
+		out.emplace_back(uint8_t(value | 0x80));
+		value >>= 7;
+	}
+	out.emplace_back(uint8_t(value));
+}
+
+static uint64_t InvertedIndex_readVarint(const uint8_t *&ptr, const uint8_t *end) {
+	uint64_t ret = 0;
+	uint32_t shift = 0;
+	while (ptr < end && shift < 64) {
+		auto b = *ptr++;
+		ret |= uint64_t(b & 0x7F) << shift;
+		if ((b & 0x80) == 0) {
+			break;
+		}
+		shift += 7;
+	}
+	return ret;
+}
+
+struct InvertedIndex_PostingCursor {
+	const uint8_t *ptr = nullptr;
+	const uint8_t *end = nullptr;
+	const uint8_t *positions = nullptr;
+	uint32_t positionsSize = 0;
+	uint32_t count = 0;
+	uint32_t doc = 0;
+	bool started = false;
+	bool valid = false;
+
+	InvertedIndex_PostingCursor(const InvertedIndex::Segment &seg, const InvertedIndex::Segment::Term *term) {
+		if (term) {
+			ptr = seg.postings.data() + term->postings;
+			end = ptr + term->postingsSize;
+			next();
+		}
+	}
+
+	bool next() {
+		if (ptr >= end) {
+			valid = false;
+			return false;
+		}
+
+		auto delta = uint32_t(InvertedIndex_readVarint(ptr, end));
+		doc = started ? doc + delta : delta;
+		count = uint32_t(InvertedIndex_readVarint(ptr, end));
+		positionsSize = uint32_t(std::min(uint64_t(end - ptr), InvertedIndex_readVarint(ptr, end)));
+		positions = ptr;
+		ptr += positionsSize;
+		started = true;
+		valid = true;
+		return true;
+	}
+
+	bool advance(uint32_t target) {
+		while (valid && doc < target) {
+			next();
+		}
+		return valid && doc == target;
+	}
+
+	template <typename Callback>
+	void foreach (const Callback &cb) const {
+		auto p = positions;
+		auto e = positions + positionsSize;
+		uint64_t pos = 0;
+		for (uint32_t i = 0; i < count && p < e; ++ i) {
+			auto v = InvertedIndex_readVarint(p, e);
+			pos += (v >> 3);
+			cb(uint32_t(pos), SearchRank(v & 0x7));
+		}
+	}
+};
+
+static void InvertedIndex_readDocs(const InvertedIndex::Segment &seg, const InvertedIndex::Segment::Term *term,
+		Vector<uint32_t> &out) {
+	if (!term) {
+		return;
+	}
+
+	out.reserve(term->docs);
+	InvertedIndex_PostingCursor cursor(seg, term);
+	while (cursor.valid) {
+		out.emplace_back(cursor.doc);
+		cursor.next();
+	}
+}
+
+// galloping search is used, when one list is much shorter then other
+static Vector<uint32_t> InvertedIndex_intersect(SpanView<uint32_t> a, SpanView<uint32_t> b) {
+	Vector<uint32_t> ret;
+	if (a.size() > b.size()) {
+		std::swap(a, b);
+	}
+
+	if (a.empty()) {
+		return ret;
+	}
+
+	ret.reserve(a.size());
+
+	auto ia = a.data(), aEnd = a.data() + a.size();
+	auto ib = b.data(), bEnd = b.data() + b.size();
+
+	if (a.size() * 32 < b.size()) {
+		for (; ia != aEnd && ib != bEnd; ++ ia) {
+			auto v = *ia;
+			size_t step = 1;
+			auto lo = ib;
+			auto hi = ib;
+			while (hi != bEnd && *hi < v) {
+				lo = hi;
+				hi = (size_t(bEnd - hi) > step) ? hi + step : bEnd;
+				step *= 2;
+			}
+			ib = std::lower_bound(lo, hi, v);
+			if (ib != bEnd && *ib == v) {
+				ret.emplace_back(v);
+			}
+		}
+	} else {
+		// branchless merge
+		while (ia != aEnd && ib != bEnd) {
+			auto va = *ia, vb = *ib;
+			if (va == vb) {
+				ret.emplace_back(va);
+			}
+			ia += (va <= vb);
+			ib += (vb <= va);
+		}
+	}
+	return ret;
+}
+
+static Vector<uint32_t> InvertedIndex_union(SpanView<uint32_t> a, SpanView<uint32_t> b) {
+	Vector<uint32_t> ret;
+	ret.reserve(a.size() + b.size());
+	std::set_union(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(ret));
+	return ret;
+}
+
+static Vector<uint32_t> InvertedIndex_difference(SpanView<uint32_t> a, SpanView<uint32_t> b) {
+	Vector<uint32_t> ret;
+	ret.reserve(a.size());
+	std::set_difference(a.begin(), a.end(), b.begin(), b.end(), std::back_inserter(ret));
+	return ret;
+}
+
+// same rules as SearchQuery_isFollow: every next word should be found after previous one within
+// its offset, with the same rank
+static Vector<uint32_t> InvertedIndex_follow(const InvertedIndex::Segment &seg, const SearchQuery &q) {
+	Vector<uint32_t> candidates;
+	Vector<const InvertedIndex::Segment::Term *> terms;
+
+	for (auto &it : q.args) {
+		auto term = seg.findTerm(it.value);
+		if (!term) {
+			return Vector<uint32_t>();
+		}
+		terms.emplace_back(term);
+	}
+
+	for (auto &it : terms) {
+		Vector<uint32_t> docs;
+		InvertedIndex_readDocs(seg, it, docs);
+		candidates = (&it == terms.data()) ? move(docs) : InvertedIndex_intersect(candidates, docs);
+		if (candidates.empty()) {
+			return candidates;
+		}
+	}
+
+	Vector<InvertedIndex_PostingCursor> cursors;
+	for (auto &it : terms) {
+		cursors.emplace_back(seg, it);
+	}
+
+	Vector<Pair<SearchRank, uint32_t>> path;
+	Vector<Pair<uint32_t, SearchRank>> positions;
+
+	Vector<uint32_t> ret;
+	for (auto doc : candidates) {
+		path.clear();
+		for (size_t i = 0; i < cursors.size(); ++ i) {
+			cursors[i].advance(doc);
+
+			if (i == 0) {
+				cursors[i].foreach([&] (uint32_t pos, SearchRank rank) {
+					path.emplace_back(rank, pos);
+				});
+				continue;
+			}
+
+			positions.clear();
+			cursors[i].foreach([&] (uint32_t pos, SearchRank rank) {
+				positions.emplace_back(pos, rank);
+			});
+
+			auto offset = std::max(q.args[i].offset, uint32_t(1));
+			auto it = path.begin();
+			while (it != path.end()) {
+				auto next = std::find_if(positions.begin(), positions.end(), [&] (const Pair<uint32_t, SearchRank> &p) {
+					return p.first > it->second && p.second == it->first;
+				});
+				if (next != positions.end() && next->first - it->second <= offset) {
+					it->second = next->first;
+					++ it;
+				} else {
+					it = path.erase(it);
+				}
+			}
+
+			if (path.empty()) {
+				break;
+			}
+		}
+
+		if (!path.empty()) {
+			ret.emplace_back(doc);
+		}
+	}
+	return ret;
+}
+
+// same rules as SearchQuery::isMatch
+static InvertedIndex_DocSet InvertedIndex_evaluate(const InvertedIndex::Segment &seg, const SearchQuery &q) {
+	InvertedIndex_DocSet ret;
+	if (!q.args.empty()) {
+		switch (q.op) {
+		case SearchOp::None:
+		case SearchOp::And: {
+			bool hasPositive = false;
+			Vector<uint32_t> positive;
+			Vector<uint32_t> negative;
+			for (auto &it : q.args) {
+				auto set = InvertedIndex_evaluate(seg, it);
+				if (set.complement) {
+					negative = InvertedIndex_union(negative, set.docs);
+				} else if (!hasPositive) {
+					positive = move(set.docs);
+					hasPositive = true;
+				} else {
+					positive = InvertedIndex_intersect(positive, set.docs);
+				}
+			}
+			if (hasPositive) {
+				ret.docs = negative.empty() ? move(positive) : InvertedIndex_difference(positive, negative);
+			} else {
+				ret.docs = move(negative);
+				ret.complement = true;
+			}
+			break;
+		}
+		case SearchOp::Or: {
+			bool hasNegative = false;
+			Vector<uint32_t> positive;
+			Vector<uint32_t> negative;
+			for (auto &it : q.args) {
+				auto set = InvertedIndex_evaluate(seg, it);
+				if (!set.complement) {
+					positive = InvertedIndex_union(positive, set.docs);
+				} else if (!hasNegative) {
+					negative = move(set.docs);
+					hasNegative = true;
+				} else {
+					negative = InvertedIndex_intersect(negative, set.docs);
+				}
+			}
+			if (hasNegative) {
+				ret.docs = InvertedIndex_difference(negative, positive);
+				ret.complement = true;
+			} else {
+				ret.docs = move(positive);
+			}
+			break;
+		}
+		case SearchOp::Follow:
+			ret.docs = InvertedIndex_follow(seg, q);
+			break;
+		}
+		if (q.neg) {
+			ret.complement = !ret.complement;
+		}
+	} else if (!q.value.empty()) {
+		InvertedIndex_readDocs(seg, seg.findTerm(q.value), ret.docs);
+		ret.complement = q.neg;
+	}
+	return ret;
+}
+
+static InvertedIndex::Segment *InvertedIndex_merge(memory::pool_t *parent,
+		SpanView<InvertedIndex::Segment *> segments) {
+	using Term = InvertedIndex::Segment::Term;
+
+	auto ret = InvertedIndex_create<InvertedIndex::Segment>(parent);
+	memory::perform([&] {
+		size_t docs = 0;
+		size_t termsData = 0;
+		size_t postings = 0;
+		for (auto &it : segments) {
+			docs += it->ids.size();
+			termsData += it->termsData.size();
+			postings += it->postings.size();
+		}
+
+		ret->ids.reserve(docs);
+		ret->lengths.reserve(docs);
+		ret->termsData.reserve(termsData);
+		ret->postings.reserve(postings);
+
+		Vector<uint32_t> offsets;
+		Vector<size_t> cursors;
+		for (auto &it : segments) {
+			offsets.emplace_back(uint32_t(ret->ids.size()));
+			cursors.emplace_back(0);
+			ret->ids.insert(ret->ids.end(), it->ids.begin(), it->ids.end());
+			ret->lengths.insert(ret->lengths.end(), it->lengths.begin(), it->lengths.end());
+		}
+
+		while (true) {
+			StringView term;
+			bool found = false;
+			for (size_t i = 0; i < segments.size(); ++ i) {
+				if (cursors[i] < segments[i]->terms.size()) {
+					auto str = segments[i]->getTerm(segments[i]->terms[cursors[i]]);
+					if (!found || str < term) {
+						term = str;
+						found = true;
+					}
+				}
+			}
+
+			if (!found) {
+				break;
+			}
+
+			Term out{uint32_t(ret->termsData.size()), uint32_t(term.size()), 0, 0, ret->postings.size()};
+			ret->termsData.append(term.data(), term.size());
+
+			uint32_t last = 0;
+			for (size_t i = 0; i < segments.size(); ++ i) {
+				auto seg = segments[i];
+				if (cursors[i] >= seg->terms.size() || seg->getTerm(seg->terms[cursors[i]]) != term) {
+					continue;
+				}
+
+				auto &t = seg->terms[cursors[i]++];
+				const uint8_t *ptr = seg->postings.data() + t.postings;
+				const uint8_t *end = ptr + t.postingsSize;
+
+				// only first document delta should be rebased, other entries are copied as is
+				uint32_t local = uint32_t(InvertedIndex_readVarint(ptr, end));
+				uint32_t global = offsets[i] + local;
+				InvertedIndex_writeVarint(ret->postings, (out.docs == 0) ? global : global - last);
+				ret->postings.insert(ret->postings.end(), ptr, end);
+
+				// find last document of the list
+				while (ptr < end) {
+					InvertedIndex_readVarint(ptr, end);
+					ptr += std::min(uint64_t(end - ptr), InvertedIndex_readVarint(ptr, end));
+					if (ptr < end) {
+						local += uint32_t(InvertedIndex_readVarint(ptr, end));
+					}
+				}
+
+				last = offsets[i] + local;
+				out.docs += t.docs;
+			}
+
+			out.postingsSize = uint32_t(ret->postings.size() - out.postings);
+			ret->terms.emplace_back(out);
+		}
+	}, ret->pool);
+	return ret;
+}
+
+InvertedIndex::~InvertedIndex() {
+	if (_buffer) {
+		InvertedIndex_destroy(_buffer);
+		_buffer = nullptr;
+	}
+	for (auto &it : _segments) {
+		InvertedIndex_destroy(it);
+	}
+	_segments.clear();
+}
+
+bool InvertedIndex::init() { return init(Config()); }
+
+bool InvertedIndex::init(const Config &cfg) {
+	_pool = memory::pool::acquire();
+	_config = cfg;
+	_config.maxBufferedDocuments = std::max(_config.maxBufferedDocuments, size_t(1));
+	_config.mergeFactor = std::max(_config.mergeFactor, size_t(2));
+	return true;
+}
+
+void InvertedIndex::add(int64_t id, const SearchVector &vec) {
+	if (!_buffer) {
+		_buffer = InvertedIndex_create<Buffer>(_pool);
+	}
+
+	memory::perform([&, this] {
+		auto doc = uint32_t(_buffer->ids.size());
+		_buffer->ids.emplace_back(id);
+		_buffer->lengths.emplace_back(uint32_t(vec.documentLength));
+
+		Bytes positions;
+		for (auto &it : vec.words) {
+			auto pit = _buffer->terms.find(it.first);
+			if (pit == _buffer->terms.end()) {
+				pit = _buffer->terms.emplace(it.first.pdup(_buffer->pool), Buffer::Postings()).first;
+			}
+
+			// matches in SearchVector are sorted by position
+			positions.clear();
+			uint64_t prev = 0;
+			for (auto &m : it.second) {
+				InvertedIndex_writeVarint(positions, (uint64_t(m.first - prev) << 3) | uint64_t(toInt(m.second)));
+				prev = m.first;
+			}
+
+			auto &postings = pit->second;
+			InvertedIndex_writeVarint(postings.data, (postings.docs == 0) ? doc : doc - postings.last);
+			InvertedIndex_writeVarint(postings.data, it.second.size());
+			InvertedIndex_writeVarint(postings.data, positions.size());
+			postings.data.insert(postings.data.end(), positions.begin(), positions.end());
+			postings.last = doc;
+			++ postings.docs;
+		}
+	}, _buffer->pool);
+
+	++ _documentsCount;
+	_documentsLength += vec.documentLength;
+
+	if (_buffer->ids.size() >= _config.maxBufferedDocuments) {
+		flush();
+	}
+}
+
+void InvertedIndex::flush() {
+	if (!_buffer) {
+		return;
+	}
+
+	if (_buffer->ids.empty()) {
+		InvertedIndex_destroy(_buffer);
+		_buffer = nullptr;
+		return;
+	}
+
+	auto seg = InvertedIndex_create<Segment>(_pool);
+	memory::perform([&, this] {
+		seg->ids.assign(_buffer->ids.begin(), _buffer->ids.end());
+		seg->lengths.assign(_buffer->lengths.begin(), _buffer->lengths.end());
+
+		size_t termsData = 0;
+		size_t postings = 0;
+		for (auto &it : _buffer->terms) {
+			termsData += it.first.size();
+			postings += it.second.data.size();
+		}
+
+		seg->terms.reserve(_buffer->terms.size());
+		seg->termsData.reserve(termsData);
+		seg->postings.reserve(postings);
+
+		for (auto &it : _buffer->terms) {
+			seg->terms.emplace_back(Segment::Term{uint32_t(seg->termsData.size()), uint32_t(it.first.size()),
+				it.second.docs, uint32_t(it.second.data.size()), seg->postings.size()});
+			seg->termsData.append(it.first.data(), it.first.size());
+			seg->postings.insert(seg->postings.end(), it.second.data.begin(), it.second.data.end());
+		}
+	}, seg->pool);
+
+	InvertedIndex_destroy(_buffer);
+	_buffer = nullptr;
+
+	_segments.emplace_back(seg);
+
+	if (_segments.size() > _config.mergeFactor) {
+		std::sort(_segments.begin(), _segments.end(), [] (const Segment *l, const Segment *r) {
+			return l->ids.size() < r->ids.size();
+		});
+		mergeSegments(0, _config.mergeFactor);
+	}
+}
+
+void InvertedIndex::merge() {
+	flush();
+	if (_segments.size() > 1) {
+		mergeSegments(0, _segments.size());
+	}
+}
+
+Vector<InvertedIndex::Result> InvertedIndex::performQuery(const SearchQuery &query, size_t maxResults) {
+	flush();
+
+	Vector<Result> ret;
+	if (_documentsCount == 0) {
+		return ret;
+	}
+
+	Vector<StringView> words;
+	query.decompose([&] (StringView word) {
+		emplace_ordered(words, word);
+	}, [&] (StringView) { });
+
+	const float N = float(_documentsCount);
+	const float avgLength = std::max(float(_documentsLength) / N, 1.0f);
+
+	Vector<float> idf;
+	for (auto &word : words) {
+		uint32_t docs = 0;
+		for (auto &seg : _segments) {
+			if (auto term = seg->findTerm(word)) {
+				docs += term->docs;
+			}
+		}
+		idf.emplace_back(std::log(1.0f + (N - float(docs) + 0.5f) / (float(docs) + 0.5f)));
+	}
+
+	Vector<float> scores;
+	for (auto &seg : _segments) {
+		auto set = InvertedIndex_evaluate(*seg, query);
+		if (set.complement) {
+			Vector<uint32_t> all;
+			all.reserve(seg->ids.size() - std::min(seg->ids.size(), set.docs.size()));
+			auto it = set.docs.begin();
+			for (uint32_t i = 0; i < uint32_t(seg->ids.size()); ++ i) {
+				if (it != set.docs.end() && *it == i) {
+					++ it;
+				} else {
+					all.emplace_back(i);
+				}
+			}
+			set.docs = move(all);
+		}
+
+		if (set.docs.empty()) {
+			continue;
+		}
+
+		scores.clear();
+		scores.resize(set.docs.size(), 0.0f);
+
+		for (size_t w = 0; w < words.size(); ++ w) {
+			auto term = seg->findTerm(words[w]);
+			if (!term) {
+				continue;
+			}
+
+			InvertedIndex_PostingCursor cursor(*seg, term);
+			for (size_t i = 0; i < set.docs.size() && cursor.valid; ++ i) {
+				auto doc = set.docs[i];
+				if (!cursor.advance(doc)) {
+					continue;
+				}
+
+				float tf = 0.0f;
+				cursor.foreach([&] (uint32_t, SearchRank rank) {
+					tf += _config.ranks.rank(rank);
+				});
+
+				auto norm = 1.0f - _config.b + _config.b * float(seg->lengths[doc]) / avgLength;
+				scores[i] += idf[w] * tf * (_config.k1 + 1.0f) / (tf + _config.k1 * norm);
+			}
+		}
+
+		for (size_t i = 0; i < set.docs.size(); ++ i) {
+			ret.emplace_back(Result{seg->ids[set.docs[i]], scores[i]});
+		}
+	}
+
+	auto scoreLess = [] (const Result &l, const Result &r) { return l.score > r.score; };
+	if (maxResults > 0 && ret.size() > maxResults) {
+		std::partial_sort(ret.begin(), ret.begin() + maxResults, ret.end(), scoreLess);
+		ret.resize(maxResults);
+	} else {
+		std::sort(ret.begin(), ret.end(), scoreLess);
+	}
+	return ret;
+}
+
+void InvertedIndex::mergeSegments(size_t first, size_t count) {
+	count = std::min(count, _segments.size() - first);
+	if (count < 2) {
+		return;
+	}
+
+	auto merged = InvertedIndex_merge(_pool, SpanView<Segment *>(_segments.data() + first, count));
+	for (size_t i = first; i < first + count; ++ i) {
+		InvertedIndex_destroy(_segments[i]);
+	}
+
+	_segments.erase(_segments.begin() + first, _segments.begin() + first + count);
+	_segments.emplace_back(merged);
+}
+
+} // namespace stappler::search
@@ -0,0 +1,97 @@
+/**
+ Copyright (c) 2025 Stappler LLC <admin@stappler.dev>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ **/
+
+
+#ifndef STAPPLER_SEARCH_SPSEARCHINVERTEDINDEX_H_
+#define STAPPLER_SEARCH_SPSEARCHINVERTEDINDEX_H_
+
+#include "SPRef.h"
+#include "SPSearchQuery.h"
+
+namespace STAPPLER_VERSIONIZED stappler::search {
+
+// Embeddable full-text index for documents, stemmed with `Configuration::makeSearchVector`
+//
+// Documents are buffered, then written into immutable segments with sorted term dictionary and
+// delta+varint compressed posting lists with positions and ranks. Segments are merged, when
+// their count exceeds mergeFactor. Queries from `Configuration::parseQuery` are evaluated with
+// the same semantics as `SearchQuery::isMatch`, results are ranked with BM25, where term
+// frequency is weighted with RankingValues for word ranks.
+//
+// Index is not thread-safe, queries should be serialized with modifications.
+class SP_PUBLIC InvertedIndex : public Ref {
+public:
+	struct Config {
+		float k1 = 1.2f;
+		float b = 0.75f;
+		RankingValues ranks;
+
+		// documents, buffered in memory before new segment is written
+		size_t maxBufferedDocuments = 1'024;
+
+		// when number of segments exceeds this value, smallest segments are merged
+		size_t mergeFactor = 8;
+	};
+
+	struct Result {
+		int64_t id = 0;
+		float score = 0.0f;
+	};
+
+	struct Segment;
+	struct Buffer;
+
+	virtual ~InvertedIndex();
+
+	bool init();
+	bool init(const Config &);
+
+	void add(int64_t id, const SearchVector &);
+
+	// Writes buffered documents into new segment
+	void flush();
+
+	// Merges all segments into single one
+	void merge();
+
+	// Buffered documents are flushed before query evaluation
+	// With maxResults > 0, only best maxResults documents are returned
+	Vector<Result> performQuery(const SearchQuery &, size_t maxResults = 0);
+
+	size_t getDocumentsCount() const { return _documentsCount; }
+	size_t getSegmentsCount() const { return _segments.size(); }
+
+protected:
+	// replaces segments in range with single merged segment
+	void mergeSegments(size_t first, size_t count);
+
+	memory::pool_t *_pool = nullptr;
+	Config _config;
+	Vector<Segment *> _segments;
+	Buffer *_buffer = nullptr;
+	size_t _documentsCount = 0;
+	uint64_t _documentsLength = 0;
+};
+
+} // namespace stappler::search
+
+#endif /* STAPPLER_SEARCH_SPSEARCHINVERTEDINDEX_H_ */
@@ -26,7 +26,7 @@ MODULE_STAPPLER_SEARCH_SRCS_DIRS := $(STAPPLER_MODULE_DIR)/search
 MODULE_STAPPLER_SEARCH_SRCS_OBJS :=
 MODULE_STAPPLER_SEARCH_INCLUDES_DIRS :=
 MODULE_STAPPLER_SEARCH_INCLUDES_OBJS := $(STAPPLER_MODULE_DIR)/search
-MODULE_STAPPLER_SEARCH_DEPENDS_ON := stappler_data
+MODULE_STAPPLER_SEARCH_DEPENDS_ON := stappler_data stappler_filesystem
 
 #spec
 
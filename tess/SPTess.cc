@@ -30,6 +30,9 @@ namespace STAPPLER_VERSIONIZED stappler::geom {
 
 static constexpr VerboseFlag TessVerbose = VerboseFlag::None;
 
+// Max number of convex contours, exported without sweep (bounding boxes checked pairwise)
+static constexpr uint32_t TessConvexContoursMax = 32;
+
 struct Tesselator::Data : ObjectAllocator {
 	// potential root face edges (connected to right non-convex angle)
 	Vec2 _bmax, _bmin, _event;
@@ -57,8 +60,26 @@ struct Tesselator::Data : ObjectAllocator {
 	memory::vector<Vertex *> _protectedVertexes;
 	memory::vector<HalfEdge *> _protectedEdges;
 
+	struct ConvexContour {
+		HalfEdge *edge = nullptr;
+		uint32_t count = 0;
+		Vec2 bmin;
+		Vec2 bmax;
+	};
+
+	// Closed contours, classified as convex on closeContour; when all contours are convex
+	// and separated, they are exported as triangle fans without sweep
+	memory::vector<ConvexContour> _convexContours;
+	bool _complexContours = false;
+	bool _convexExport = false;
+
 	Data(memory::pool_t *p);
 
+	void classifyContour(HalfEdge *, uint32_t count);
+	bool canExportConvex() const;
+	void prepareConvex(TessResult &);
+	void writeConvex(TessResult &);
+
 	bool computeInterior();
 
 	// Compute boundary face contour, also - split vertexes in subboundaries for antialiasing
@@ -272,6 +293,7 @@ bool Tesselator::closeContour(Cursor &cursor) {
 			cursor.edge->foreachOnFace(
 					[&](HalfEdge &e) { std::cout << TessVerbose << "\t" << e << "\n"; });
 		}
+		_data->classifyContour(cursor.edge, cursor.count);
 		_data->trimVertexes();
 		return true;
 	} else {
@@ -289,6 +311,7 @@ bool Tesselator::closeStrokeContour(Cursor &cursor) {
 	}
 
 	cursor.closed = true;
+	_data->_complexContours = true;
 
 	if (cursor.root) {
 		_data->_vertexes[cursor.root->vertex]->relocate(cursor.edge->origin);
@@ -318,6 +341,11 @@ bool Tesselator::prepare(TessResult &res) {
 	_data->_result = &res;
 	_data->_vertexOffset = res.nvertexes;
 
+	if (_data->canExportConvex()) {
+		_data->prepareConvex(res);
+		return true;
+	}
+
 	if ((_data->_relocateRule == RelocateRule::Monotonize)
 			&& (_data->_boundaryOffset > 0.0f || _data->_boundaryInset > 0.0f)) {
 		_data->_dryRun = true;
@@ -415,6 +443,11 @@ bool Tesselator::write(TessResult &res) {
 		return false;
 	}
 
+	if (_data->_convexExport) {
+		_data->writeConvex(res);
+		return true;
+	}
+
 	uint32_t triangle[3] = {0};
 
 	auto exportQuad = [&, this](uint32_t tl, uint32_t tr, uint32_t bl, uint32_t br) {
@@ -2398,4 +2431,224 @@ void Tesselator::Data::displaceBoundary(FaceEdge *edge) {
 	}
 }
 
+void Tesselator::Data::classifyContour(HalfEdge *edge, uint32_t count) {
+	if (_complexContours) {
+		return;
+	}
+
+	if (count < 3 || _convexContours.size() >= TessConvexContoursMax) {
+		_complexContours = true;
+		return;
+	}
+
+	ConvexContour contour{edge, 0, edge->origin, edge->origin};
+
+	// Contour is convex, when all turns have the same direction and it is x-monotone
+	// (direction along X axis changes no more then twice, otherwise contour winds multiple times)
+	float turn = 0.0f;
+	float dirFirst = 0.0f;
+	float dirPrev = 0.0f;
+	uint32_t dirChanges = 0;
+
+	auto e = edge;
+	do {
+		auto &v0 = e->origin;
+		auto &v1 = e->_leftNext->origin;
+		auto &v2 = e->_leftNext->_leftNext->origin;
+
+		const auto cross = Vec2::cross(v1 - v0, v2 - v1);
+		if (cross != 0.0f) {
+			if (turn == 0.0f) {
+				turn = cross;
+			} else if ((turn > 0.0f) != (cross > 0.0f)) {
+				_complexContours = true;
+				return;
+			}
+		}
+
+		if (v1.x != v0.x) {
+			const auto dir = (v1.x > v0.x) ? 1.0f : -1.0f;
+			if (dirFirst == 0.0f) {
+				dirFirst = dir;
+			} else if (dir != dirPrev) {
+				++dirChanges;
+			}
+			dirPrev = dir;
+		}
+
+		contour.bmin.x = std::min(contour.bmin.x, v0.x);
+		contour.bmin.y = std::min(contour.bmin.y, v0.y);
+		contour.bmax.x = std::max(contour.bmax.x, v0.x);
+		contour.bmax.y = std::max(contour.bmax.y, v0.y);
+
+		++contour.count;
+		e = e->_leftNext;
+	} while (e != edge);
+
+	if (dirPrev != dirFirst) {
+		++dirChanges;
+	}
+
+	if (turn == 0.0f || dirChanges > 2) {
+		_complexContours = true;
+		return;
+	}
+
+	_convexContours.emplace_back(contour);
+}
+
+bool Tesselator::Data::canExportConvex() const {
+	if (_complexContours || _convexContours.empty()) {
+		return false;
+	}
+
+	// single contour has winding 1 or -1 on both sides of sweep line
+	if (_winding != Winding::NonZero && _winding != Winding::EvenOdd) {
+		return false;
+	}
+
+	if (_relocateRule == RelocateRule::Monotonize || _relocateRule == RelocateRule::DistanceField) {
+		return false;
+	}
+
+	// vertexes from unclosed contours should be processed with sweep
+	uint32_t nvertexes = 0;
+	for (auto &it : _vertexes) {
+		if (it) {
+			++nvertexes;
+		}
+	}
+
+	for (auto &it : _convexContours) { nvertexes -= it.count; }
+
+	if (nvertexes != 0) {
+		return false;
+	}
+
+	// contours should not overlap, otherwise winding should be calculated
+	for (size_t i = 0; i < _convexContours.size(); ++i) {
+		auto &a = _convexContours[i];
+		for (size_t j = i + 1; j < _convexContours.size(); ++j) {
+			auto &b = _convexContours[j];
+			if (a.bmin.x < b.bmax.x && b.bmin.x < a.bmax.x && a.bmin.y < b.bmax.y
+					&& b.bmin.y < a.bmax.y) {
+				return false;
+			}
+		}
+	}
+
+	return true;
+}
+
+void Tesselator::Data::prepareConvex(TessResult &res) {
+	_convexExport = true;
+
+	const bool boundary = _boundaryOffset > 0.0f || _boundaryInset > 0.0f;
+
+	for (auto &it : _convexContours) {
+		if (boundary) {
+			// interior and boundary vertex for each contour vertex, fan and quad for each edge
+			res.nvertexes += it.count * 2;
+			res.nfaces += it.count - 2 + it.count * 2;
+		} else {
+			res.nvertexes += it.count;
+			res.nfaces += it.count - 2;
+		}
+	}
+}
+
+void Tesselator::Data::writeConvex(TessResult &res) {
+	const bool boundary = _boundaryOffset > 0.0f || _boundaryInset > 0.0f;
+
+	// same rules as in displaceBoundary, convex contour has no split vertexes
+	float offsetValue = _boundaryOffset;
+	float insetValue = _boundaryInset;
+	if (_relocateRule != RelocateRule::Always) {
+		offsetValue += _boundaryInset * 0.5f;
+		insetValue = 0.0f;
+	}
+
+	uint32_t triangle[3] = {0};
+	uint32_t offset = _vertexOffset;
+
+	for (auto &contour : _convexContours) {
+		const uint32_t n = contour.count;
+
+		float area = 0.0f;
+		Vec2 center;
+
+		auto e = contour.edge;
+		do {
+			area += Vec2::cross(e->origin, e->_leftNext->origin);
+			center += e->origin;
+			e = e->_leftNext;
+		} while (e != contour.edge);
+
+		center /= float(n);
+
+		// export triangles in CCW order, like the sweep does
+		const bool reverse = area < 0.0f;
+		auto next = [&](HalfEdge *it) { return reverse ? it->getLeftLoopPrev() : it->_leftNext; };
+		auto prev = [&](HalfEdge *it) { return reverse ? it->_leftNext : it->getLeftLoopPrev(); };
+
+		uint32_t idx = 0;
+		e = contour.edge;
+		do {
+			if (boundary) {
+				auto &v0 = prev(e)->origin;
+				auto &v1 = e->origin;
+				auto &v2 = next(e)->origin;
+
+				Vec4 result;
+				getVertexNormal(&v0.x, &v1.x, &v2.x, &result.x);
+
+				// bisector points inside for convex angle, direction is ambiguous for straight one
+				Vec2 norm(result.z, result.w);
+				if (Vec2::dot(norm, v1 - center) < 0.0f) {
+					norm = -norm;
+				}
+
+				float value = 0.0f;
+				if (std::isnan(result.y) || result.y > 3.0f) {
+					value = 1.0f - 3.0f / result.y;
+					result.y = 3.0f;
+				}
+
+				const auto inner = v1 - norm * (result.y * insetValue);
+				const auto outer = v1 + norm * (result.y * offsetValue);
+
+				res.pushVertex(res.target, offset + idx, inner, 1.0f, norm);
+				res.pushVertex(res.target, offset + n + idx, outer, value,
+						(inner - outer).getNormalized());
+
+				const auto nextIdx = (idx + 1) % n;
+
+				triangle[0] = offset + idx;
+				triangle[1] = offset + n + idx;
+				triangle[2] = offset + n + nextIdx;
+				res.pushTriangle(res.target, triangle);
+
+				triangle[0] = offset + idx;
+				triangle[1] = offset + n + nextIdx;
+				triangle[2] = offset + nextIdx;
+				res.pushTriangle(res.target, triangle);
+			} else {
+				res.pushVertex(res.target, offset + idx, e->origin, 1.0f, Vec2::ZERO);
+			}
+
+			++idx;
+			e = next(e);
+		} while (e != contour.edge);
+
+		for (uint32_t i = 1; i < n - 1; ++i) {
+			triangle[0] = offset;
+			triangle[1] = offset + i;
+			triangle[2] = offset + i + 1;
+			res.pushTriangle(res.target, triangle);
+		}
+
+		offset += boundary ? n * 2 : n;
+	}
+}
+
 } // namespace stappler::geom
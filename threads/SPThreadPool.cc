@@ -42,6 +42,42 @@ protected:
 	StringView _name;
 };
 
+struct ThreadPool_ParallelData : public Ref {
+	std::atomic<uint32_t> next = 0;
+	std::atomic<uint32_t> completed = 0;
+	uint32_t nchunks = 0;
+	uint32_t count = 0;
+	uint32_t grain = 0;
+
+	// only used while there are unclaimed chunks, so it's safe to keep pointer to caller's stack
+	const Callback<void(uint32_t, uint32_t)> *callback = nullptr;
+
+	std::mutex mutex;
+	std::condition_variable cond;
+
+	void run() {
+		while (true) {
+			auto chunk = next.fetch_add(1);
+			if (chunk >= nchunks) {
+				return;
+			}
+
+			auto first = chunk * grain;
+			(*callback)(first, std::min(first + grain, count));
+
+			if (completed.fetch_add(1) + 1 == nchunks) {
+				std::unique_lock lock(mutex);
+				cond.notify_all();
+			}
+		}
+	}
+
+	void wait() {
+		std::unique_lock lock(mutex);
+		cond.wait(lock, [&] { return completed.load() == nchunks; });
+	}
+};
+
 bool ThreadPool::init(ThreadPoolInfo &&info) { return _context.init(move(info), this); }
 
 Status ThreadPool::perform(Rc<Task> &&task, bool first) {
@@ -69,6 +105,33 @@ Status ThreadPool::performCompleted(mem_std::Function<void()> &&func, Ref *targe
 	return _context.info.complete->perform(sp::move(func), target);
 }
 
+void ThreadPool::performParallel(uint32_t count, uint32_t grain,
+		const Callback<void(uint32_t, uint32_t)> &cb) {
+	grain = std::max(grain, uint32_t(1));
+	if (count <= grain) {
+		if (count > 0) {
+			cb(0, count);
+		}
+		return;
+	}
+
+	auto data = Rc<ThreadPool_ParallelData>::alloc();
+	data->count = count;
+	data->grain = grain;
+	data->nchunks = (count - 1) / grain + 1;
+	data->callback = &cb;
+
+	auto ntasks = std::min(uint32_t(_context.info.threadCount), data->nchunks - 1);
+	for (uint32_t i = 0; i < ntasks; ++i) {
+		if (perform([data] { data->run(); }, data) != Status::Ok) {
+			break; // remaining chunks will be processed on this thread
+		}
+	}
+
+	data->run();
+	data->wait();
+}
+
 void ThreadPool::cancel() { _context.cancel(); }
 
 bool ThreadPool::isRunning() const {
@@ -72,6 +72,13 @@ public:
 	Status performCompleted(Rc<Task> &&task);
 	Status performCompleted(mem_std::Function<void()> &&func, Ref * = nullptr);
 
+	// Calls callback for ranges of `grain` indexes, that covers [0, count), on pool's workers
+	// and on calling thread, returns when all ranges are processed
+	// Ranges are claimed dynamically, so calling thread never waits for range, that was not
+	// started: it's safe to call from pool's own worker, or when pool does not accept tasks
+	void performParallel(uint32_t count, uint32_t grain,
+			const Callback<void(uint32_t first, uint32_t last)> &);
+
 	// stop all workers
 	void cancel();
 
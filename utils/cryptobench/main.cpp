@@ -0,0 +1,166 @@
+/**
+ Copyright (c) 2025 Stappler LLC <admin@stappler.dev>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ **/
+
+#include "SPCommon.h" // IWYU pragma: keep
+#include "SPCrypto.h"
+#include "SPJsonWebToken.h"
+#include "SPMemory.h"
+#include "SPTime.h"
+
+namespace stappler::cryptobench {
+
+using namespace mem_std;
+
+// Compares one-shot block functions (backend objects are created for every call) with
+// reusable crypto::CipherContext, for raw blocks and for AesToken round-trips.
+// Every iteration uses its own key, like AesToken does, so only backend setup is saved
+
+static constexpr size_t DefaultIterations = 100'000;
+
+static constexpr auto HELP_STRING =
+		R"(stappler-cryptobench [<iterations>] - block cipher and AesToken throughput
+Prints operations per second for one-shot functions and for reusable CipherContext
+)";
+
+static void printResult(StringView backend, StringView name, size_t iterations, TimeInterval t) {
+	auto sec = double(t.toMicros()) / 1'000'000.0;
+	std::cout << backend << "\t" << name << "\t" << size_t(iterations / sec) << " ops/s\n";
+}
+
+template <typename Fn>
+static TimeInterval measure(size_t iterations, const Fn &fn) {
+	auto t = Time::now();
+	for (size_t i = 0; i < iterations; ++i) { fn(i); }
+	return Time::now() - t;
+}
+
+static Vector<crypto::BlockKey256> makeKeys(size_t count, BytesView secret) {
+	Vector<crypto::BlockKey256> ret;
+	ret.reserve(count);
+	for (size_t i = 0; i < count; ++i) {
+		ret.emplace_back(crypto::makeBlockKey(secret, BytesView((const uint8_t *)&i, sizeof(i))));
+	}
+	return ret;
+}
+
+static void runBlocks(crypto::Backend b, StringView title, size_t iterations, BytesView secret,
+		BytesView payload) {
+	auto keys = makeKeys(iterations, secret);
+	size_t failed = 0;
+
+	auto roundTrip = [&](const auto &enc, const auto &dec, size_t i) {
+		auto success = enc(keys[i], payload, [&](BytesView data) {
+			auto decoded = dec(keys[i], data, [&](BytesView out) {
+				if (out != payload) {
+					++failed;
+				}
+			});
+			if (!decoded) {
+				++failed;
+			}
+		});
+		if (!success) {
+			++failed;
+		}
+	};
+
+	auto oneShot = measure(iterations, [&](size_t i) {
+		roundTrip([&](const crypto::BlockKey256 &key, BytesView data, const auto &cb) {
+			return crypto::encryptBlock(b, key, data, cb);
+		}, [&](const crypto::BlockKey256 &key, BytesView data, const auto &cb) {
+			return crypto::decryptBlock(b, key, data, cb);
+		}, i);
+	});
+
+	crypto::CipherContext ctx(b);
+	auto reused = measure(iterations, [&](size_t i) {
+		roundTrip([&](const crypto::BlockKey256 &key, BytesView data, const auto &cb) {
+			return crypto::encryptBlock(ctx, key, data, cb);
+		}, [&](const crypto::BlockKey256 &key, BytesView data, const auto &cb) {
+			return crypto::decryptBlock(ctx, key, data, cb);
+		}, i);
+	});
+
+	printResult(title, "block one-shot", iterations, oneShot);
+	printResult(title, "block context", iterations, reused);
+	if (failed) {
+		std::cout << title << "\t" << failed << " failed round-trips\n";
+	}
+}
+
+static void runTokens(size_t iterations, BytesView secret) {
+	using Token = AesToken<memory::StandartInterface>;
+
+	Token::Fingerprint fp(crypto::HashFunction::SHA_2, BytesView(secret));
+
+	auto run = [&](Token::Keys keys) {
+		size_t failed = 0;
+		auto t = measure(iterations, [&](size_t i) {
+			auto token = Token::create(keys);
+			token.getData().setString("user", "name");
+			token.getData().setInteger(int64_t(i), "id");
+
+			auto data = token.exportData(fp);
+			auto parsed = Token::parse(data, fp, keys);
+			if (!parsed.getData().isInteger("id") || parsed.getData().getInteger("id") != int64_t(i)) {
+				++failed;
+			}
+		});
+		return std::pair(t, failed);
+	};
+
+	auto oneShot = run(Token::Keys{nullptr, nullptr, secret});
+
+	crypto::CipherContext ctx;
+	auto reused = run(Token::Keys{nullptr, nullptr, secret, &ctx});
+
+	printResult("Default", "AesToken one-shot", iterations, oneShot.first);
+	printResult("Default", "AesToken context", iterations, reused.first);
+	if (oneShot.second || reused.second) {
+		std::cout << "Default\t" << (oneShot.second + reused.second) << " failed tokens\n";
+	}
+}
+
+SP_EXTERN_C int main(int argc, const char *argv[]) {
+	size_t iterations = DefaultIterations;
+	if (argc > 1) {
+		if (StringView(argv[1]) == "help") {
+			std::cout << HELP_STRING;
+			return 0;
+		}
+		iterations = StringView(argv[1]).readInteger(10).get(DefaultIterations);
+	}
+
+	return perform_main(argc, argv, [&]() -> int {
+		const StringView secret("cryptobench-secret");
+		const StringView payload("{\"user\":\"name\",\"id\":1234567890,\"roles\":[\"admin\"]}");
+
+		crypto::listBackends([&](crypto::Backend b, StringView title, crypto::BackendFlags) {
+			runBlocks(b, title, iterations, BytesView(secret), BytesView(payload));
+		});
+
+		runTokens(iterations, BytesView(secret));
+		return 0;
+	});
+}
+
+} // namespace stappler::cryptobench
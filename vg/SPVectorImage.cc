@@ -373,6 +373,8 @@ const Interface::MapType<Interface::StringType, Rc<VectorPath>> &VectorImageData
 }
 
 Rc<VectorPath> VectorImageData::copyPath(StringView str) {
+	_snapshot = false;
+
 	auto it = _paths.find(str);
 	if (it != _paths.end()) {
 		it->second = Rc<VectorPath>::alloc(*it->second);
@@ -389,6 +391,8 @@ uint16_t VectorImageData::getNextId() {
 
 Rc<VectorPath> VectorImageData::addPath(StringView id, StringView cache, VectorPath &&path,
 		Mat4 mat) {
+	_snapshot = false;
+
 	String idStr;
 	if (id.empty()) {
 		idStr = mem_std::toString("auto-", getNextId());
@@ -713,6 +717,7 @@ bool VectorImage::isBatchDrawing() const { return _data->isBatchDrawing(); }
 
 Rc<VectorImageData> VectorImage::popData() {
 	markCopyOnWrite();
+	_data->_snapshot = true;
 	return _data;
 }
 
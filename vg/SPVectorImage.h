@@ -141,7 +141,14 @@ public:
 	void draw(const Callback<void(VectorPath &, StringView id, StringView cache, const Mat4 &,
 					const Color4F &)> &cb) const;
 
+	// data was returned from VectorImage::popData and was not modified since: image copies
+	// data and paths on write, so paths of snapshot are immutable
+	bool isSnapshot() const { return _snapshot; }
+
 protected:
+	friend class VectorImage;
+
+	bool _snapshot = false;
 	bool _allowBatchDrawing = true;
 	Size2 _imageSize;
 	Rect _viewBox;
@@ -0,0 +1,510 @@
+/**
+ Copyright (c) 2025 Stappler LLC <admin@stappler.dev>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ **/
+
+#include "SPVectorTess.h"
+
+#if MODULE_STAPPLER_THREADS
+#include "SPThreadPool.h"
+#endif
+
+namespace STAPPLER_VERSIONIZED stappler::vg {
+
+struct VectorTessExport {
+	VectorTessMesh::Buffer *buffer;
+	const Mat4 *transform;
+};
+
+static void VectorTess_draw(LineDrawer &drawer, const Interface::VectorType<Command> &commands,
+		const CommandData *d) {
+	for (auto &it : commands) {
+		switch (it) {
+		case Command::MoveTo:
+			drawer.drawBegin(d[0].p.x, d[0].p.y);
+			d += 1;
+			break;
+		case Command::LineTo:
+			drawer.drawLine(d[0].p.x, d[0].p.y);
+			d += 1;
+			break;
+		case Command::QuadTo:
+			drawer.drawQuadBezier(d[0].p.x, d[0].p.y, d[1].p.x, d[1].p.y);
+			d += 2;
+			break;
+		case Command::CubicTo:
+			drawer.drawCubicBezier(d[0].p.x, d[0].p.y, d[1].p.x, d[1].p.y, d[2].p.x, d[2].p.y);
+			d += 3;
+			break;
+		case Command::ArcTo:
+			drawer.drawArc(d[0].p.x, d[0].p.y, d[2].f.v, d[2].f.a, d[2].f.b, d[1].p.x, d[1].p.y);
+			d += 3;
+			break;
+		case Command::ClosePath: drawer.drawClose(true); break;
+		}
+	}
+	drawer.drawClose(false);
+}
+
+// Arc radii and stroke width can be converted into target space only with rotation,
+// uniform scale and translation (no shear, reflection or perspective)
+static bool VectorTess_isSimilarity(const Mat4 &t, float &scale, float &rotation) {
+	if (t.m[3] != 0.0f || t.m[7] != 0.0f || t.m[15] != 1.0f) {
+		return false;
+	}
+
+	const float a = t.m[0], b = t.m[1], c = t.m[4], d = t.m[5];
+
+	scale = std::sqrt(a * a + b * b);
+	if (scale < std::numeric_limits<float>::epsilon()) {
+		return false;
+	}
+
+	const float tolerance = scale * 1e-5f;
+	if (std::abs(a - d) > tolerance || std::abs(b + c) > tolerance) {
+		return false;
+	}
+
+	rotation = std::atan2(b, a);
+	return true;
+}
+
+// Transforms path points into target space; runs of plain points between arcs are
+// transformed with single batch call
+static void VectorTess_transformPoints(const VectorPath &path, const Mat4 &t, float scale,
+		float rotation, memory::vector<CommandData> &out) {
+	auto &points = path.getPoints();
+
+	out.resize(points.size());
+
+	auto src = points.data();
+	auto dst = out.data();
+
+	size_t offset = 0;
+	size_t runStart = 0;
+
+	auto flush = [&](size_t end) {
+		if (end > runStart) {
+			t.transformPoints((const Vec2 *)(src + runStart), (Vec2 *)(dst + runStart),
+					end - runStart);
+		}
+	};
+
+	for (auto &it : path.getCommands()) {
+		switch (it) {
+		case Command::MoveTo:
+		case Command::LineTo: offset += 1; break;
+		case Command::QuadTo: offset += 2; break;
+		case Command::CubicTo: offset += 3; break;
+		case Command::ArcTo:
+			flush(offset);
+
+			dst[offset] = CommandData(src[offset].p.x * scale, src[offset].p.y * scale);
+			t.transformPoints((const Vec2 *)(src + offset + 1), (Vec2 *)(dst + offset + 1), 1);
+			dst[offset + 2] = CommandData(src[offset + 2].f.v + rotation, src[offset + 2].f.a,
+					src[offset + 2].f.b);
+
+			offset += 3;
+			runStart = offset;
+			break;
+		case Command::ClosePath: break;
+		}
+	}
+
+	flush(offset);
+}
+
+static bool VectorTess_export(Tesselator &tess, VectorTessMesh::Buffer &buffer,
+		const Mat4 *transform) {
+	VectorTessExport target{&buffer, transform};
+
+	TessResult result;
+	result.target = &target;
+	if (transform) {
+		result.pushVertex = [](void *ptr, uint32_t idx, const Vec2 &pt, float value,
+									const Vec2 &norm) {
+			auto target = (VectorTessExport *)ptr;
+			Vec4 n;
+			target->transform->transformVector(norm.x, norm.y, 0.0f, 0.0f, &n);
+			target->buffer->vertexes[idx] = VectorTessVertex{
+				target->transform->transformPoint(pt), Vec2(n.x, n.y), value};
+		};
+	} else {
+		result.pushVertex = [](void *ptr, uint32_t idx, const Vec2 &pt, float value,
+									const Vec2 &norm) {
+			auto target = (VectorTessExport *)ptr;
+			target->buffer->vertexes[idx] = VectorTessVertex{pt, norm, value};
+		};
+	}
+	result.pushTriangle = [](void *ptr, uint32_t tri[3]) {
+		auto target = (VectorTessExport *)ptr;
+		target->buffer->indexes.emplace_back(tri[0]);
+		target->buffer->indexes.emplace_back(tri[1]);
+		target->buffer->indexes.emplace_back(tri[2]);
+	};
+
+	if (!tess.prepare(result)) {
+		return false;
+	}
+
+	buffer.vertexes.resize(result.nvertexes);
+	buffer.indexes.reserve(result.nfaces * 3);
+
+	return tess.write(result);
+}
+
+// LineDrawer tightens tolerance for wide strokes by log2 of stroke width
+static float VectorTess_getStrokeFactor(float width) {
+	return (width > 1.0f) ? log2f(width) : 1.0f;
+}
+
+// With similarity transform, path points are transformed in batch, and curves are flattened
+// directly in target space. Otherwise, curves are approximated in path coordinates, so
+// tolerance and antialiasing border are converted from target pixels with transform's scale,
+// and output vertexes are transformed one by one
+static Rc<VectorTessMesh> VectorTess_run(const VectorPath &path, const Mat4 &transform,
+		const VectorTessConfig &config) {
+	float s = 1.0f;
+	float rotation = 0.0f;
+
+	const bool targetSpace = VectorTess_isSimilarity(transform, s, rotation);
+	if (!targetSpace) {
+		Vec3 scale;
+		transform.getScale(&scale);
+
+		s = std::max(std::abs(scale.x), std::abs(scale.y));
+		if (s < std::numeric_limits<float>::epsilon()) {
+			return nullptr;
+		}
+	}
+
+	auto ret = Rc<VectorTessMesh>::alloc();
+	auto style = path.getStyle();
+
+	auto pool = memory::pool::create();
+	memory::perform([&] {
+		auto e = s / config.quality;
+		auto antialias = path.isAntialiased() ? config.antialiasValue / s : 0.0f;
+		auto strokeWidth = path.getStrokeWidth();
+		auto points = path.getPoints().data();
+		auto exportTransform = &transform;
+
+		memory::vector<CommandData> targetPoints;
+		if (targetSpace) {
+			VectorTess_transformPoints(path, transform, s, rotation, targetPoints);
+
+			e = 1.0f / config.quality;
+			antialias = path.isAntialiased() ? config.antialiasValue : 0.0f;
+			if ((style & DrawFlags::Stroke) != DrawFlags::None) {
+				// stroke tolerance depends on path's own stroke width, as in path space,
+				// not on the scaled one
+				e *= VectorTess_getStrokeFactor(strokeWidth)
+						/ VectorTess_getStrokeFactor(strokeWidth * s);
+			}
+			strokeWidth *= s;
+			points = targetPoints.data();
+			exportTransform = nullptr;
+		}
+
+		Rc<Tesselator> fill;
+		Rc<Tesselator> stroke;
+
+		if ((style & DrawFlags::Fill) != DrawFlags::None) {
+			fill = Rc<Tesselator>::create(pool);
+			fill->setWindingRule(path.getWindingRule());
+			fill->setAntialiasValue(antialias);
+		}
+
+		if ((style & DrawFlags::Stroke) != DrawFlags::None) {
+			stroke = Rc<Tesselator>::create(pool);
+			stroke->setWindingRule(Winding::NonZero);
+			stroke->setAntialiasValue(antialias);
+		}
+
+		do {
+			LineDrawer drawer(e, Rc<Tesselator>(fill), Rc<Tesselator>(stroke), nullptr,
+					strokeWidth, path.getLineJoin(), path.getLineCup());
+			drawer._miterLimit = path.getMiterLimit();
+
+			VectorTess_draw(drawer, path.getCommands(), points);
+		} while (0);
+
+		if (fill) {
+			VectorTess_export(*fill, ret->fill, exportTransform);
+		}
+
+		if (stroke) {
+			VectorTess_export(*stroke, ret->stroke, exportTransform);
+		}
+	}, pool);
+	memory::pool::destroy(pool);
+
+	return ret;
+}
+
+// Hash of path geometry and params, that affects tesselation (colors are excluded)
+static uint64_t VectorTess_hash(const VectorPath &path) {
+	struct Params {
+		uint32_t style;
+		float strokeWidth;
+		uint32_t winding;
+		uint32_t lineCup;
+		uint32_t lineJoin;
+		float miterLimit;
+		uint32_t antialiased;
+	};
+
+	Params params;
+	memset(&params, 0, sizeof(Params));
+	params.style = toInt(path.getStyle());
+	params.strokeWidth = path.getStrokeWidth();
+	params.winding = toInt(path.getWindingRule());
+	params.lineCup = toInt(path.getLineCup());
+	params.lineJoin = toInt(path.getLineJoin());
+	params.miterLimit = path.getMiterLimit();
+	params.antialiased = path.isAntialiased() ? 1 : 0;
+
+	auto &commands = path.getCommands();
+	auto &points = path.getPoints();
+
+	// arc flags shares storage with padding, so values are copied explicitly
+	Interface::VectorType<float> values;
+	values.reserve(points.size() * 2);
+
+	auto d = points.data();
+	for (auto &it : commands) {
+		switch (it) {
+		case Command::MoveTo:
+		case Command::LineTo:
+			values.emplace_back(d[0].p.x);
+			values.emplace_back(d[0].p.y);
+			d += 1;
+			break;
+		case Command::QuadTo:
+			for (size_t i = 0; i < 2; ++i) {
+				values.emplace_back(d[i].p.x);
+				values.emplace_back(d[i].p.y);
+			}
+			d += 2;
+			break;
+		case Command::CubicTo:
+			for (size_t i = 0; i < 3; ++i) {
+				values.emplace_back(d[i].p.x);
+				values.emplace_back(d[i].p.y);
+			}
+			d += 3;
+			break;
+		case Command::ArcTo:
+			values.emplace_back(d[0].p.x);
+			values.emplace_back(d[0].p.y);
+			values.emplace_back(d[1].p.x);
+			values.emplace_back(d[1].p.y);
+			values.emplace_back(d[2].f.v);
+			values.emplace_back(d[2].f.a ? 1.0f : 0.0f);
+			values.emplace_back(d[2].f.b ? 1.0f : 0.0f);
+			d += 3;
+			break;
+		case Command::ClosePath: break;
+		}
+	}
+
+	auto hash = hash::hash64((const char *)&params, sizeof(Params));
+	hash = hash::hash64((const char *)commands.data(), commands.size() * sizeof(Command), hash);
+	return hash::hash64((const char *)values.data(), values.size() * sizeof(float), hash);
+}
+
+static void VectorTess_parallel(thread::ThreadPool *pool, uint32_t count,
+		const Callback<void(uint32_t)> &cb) {
+#if MODULE_STAPPLER_THREADS
+	if (pool) {
+		pool->performParallel(count, 1, [&](uint32_t first, uint32_t last) {
+			for (uint32_t i = first; i < last; ++i) { cb(i); }
+		});
+		return;
+	}
+#endif
+	for (uint32_t i = 0; i < count; ++i) { cb(i); }
+}
+
+Rc<VectorTessMesh> tessellate(const VectorPath &path, const Mat4 &transform,
+		const VectorTessConfig &config) {
+	return VectorTess_run(path, transform * path.getTransform(), config);
+}
+
+bool VectorTessCache::Key::operator<(const Key &other) const {
+	if (hash != other.hash) {
+		return hash < other.hash;
+	}
+	if (quality != other.quality) {
+		return quality < other.quality;
+	}
+	if (antialiasValue != other.antialiasValue) {
+		return antialiasValue < other.antialiasValue;
+	}
+	return memcmp(transform.m, other.transform.m, sizeof(transform.m)) < 0;
+}
+
+bool VectorTessCache::init() { return true; }
+
+auto VectorTessCache::tessellate(const VectorImageData &data, const Mat4 &transform,
+		const VectorTessConfig &config, thread::ThreadPool *pool)
+		-> Interface::VectorType<VectorTessDrawItem> {
+	struct Pending {
+		Key key;
+		const VectorPath *path;
+		Mat4 transform;
+		Rc<VectorTessMesh> mesh;
+	};
+
+	Interface::VectorType<VectorTessDrawItem> ret;
+	Interface::VectorType<Pending> pending;
+	Interface::VectorType<std::pair<size_t, size_t>> pendingItems; // item index, pending index
+
+	auto baseTransform = transform * data.getViewBoxTransform();
+
+	std::unique_lock lock(_mutex);
+	data.draw([&](VectorPath &path, StringView id, StringView cacheId, const Mat4 &mat,
+					  const Color4F &color) {
+		Key key;
+		key.hash = data.isSnapshot() ? getHash(path) : VectorTess_hash(path);
+		key.transform = baseTransform * mat * path.getTransform();
+		key.quality = config.quality;
+		key.antialiasValue = path.isAntialiased() ? config.antialiasValue : 0.0f;
+
+		auto &item = ret.emplace_back(VectorTessDrawItem{nullptr,
+			Color4F(path.getFillColor()) * color, Color4F(path.getStrokeColor()) * color, id,
+			cacheId});
+
+		auto it = _meshes.find(key);
+		if (it != _meshes.end()) {
+			it->second.generation = _generation;
+			item.mesh = it->second.mesh;
+			return;
+		}
+
+		// same path can be used multiple times in draw order
+		for (size_t i = 0; i < pending.size(); ++i) {
+			if (!(pending[i].key < key) && !(key < pending[i].key)) {
+				pendingItems.emplace_back(ret.size() - 1, i);
+				return;
+			}
+		}
+
+		pendingItems.emplace_back(ret.size() - 1, pending.size());
+		pending.emplace_back(Pending{key, &path, key.transform});
+	});
+	lock.unlock();
+
+	if (pending.empty()) {
+		return ret;
+	}
+
+	VectorTess_parallel(pool, uint32_t(pending.size()), [&](uint32_t idx) {
+		auto &p = pending[idx];
+		p.mesh = VectorTess_run(*p.path, p.transform, config);
+	});
+
+	for (auto &it : pendingItems) { ret[it.first].mesh = pending[it.second].mesh; }
+
+	lock.lock();
+	for (auto &it : pending) {
+		if (it.mesh) {
+			_meshes.insert_or_assign(it.key, MeshEntry{it.mesh, _generation});
+		}
+	}
+
+	return ret;
+}
+
+Rc<VectorTessMesh> VectorTessCache::tessellate(const VectorPath &path, const Mat4 &transform,
+		const VectorTessConfig &config) {
+	// standalone path can be modified in place, so hash is not memoized
+	Key key;
+	key.hash = VectorTess_hash(path);
+	key.transform = transform * path.getTransform();
+	key.quality = config.quality;
+	key.antialiasValue = path.isAntialiased() ? config.antialiasValue : 0.0f;
+
+	std::unique_lock lock(_mutex);
+	auto it = _meshes.find(key);
+	if (it != _meshes.end()) {
+		it->second.generation = _generation;
+		return it->second.mesh;
+	}
+	lock.unlock();
+
+	auto mesh = VectorTess_run(path, key.transform, config);
+
+	lock.lock();
+	if (mesh) {
+		_meshes.insert_or_assign(key, MeshEntry{mesh, _generation});
+	}
+	return mesh;
+}
+
+void VectorTessCache::sweep() {
+	std::unique_lock lock(_mutex);
+
+	auto hit = _hashes.begin();
+	while (hit != _hashes.end()) {
+		if (hit->second.generation != _generation) {
+			hit = _hashes.erase(hit);
+		} else {
+			++hit;
+		}
+	}
+
+	auto mit = _meshes.begin();
+	while (mit != _meshes.end()) {
+		if (mit->second.generation != _generation) {
+			mit = _meshes.erase(mit);
+		} else {
+			++mit;
+		}
+	}
+
+	++_generation;
+}
+
+void VectorTessCache::clear() {
+	std::unique_lock lock(_mutex);
+	_hashes.clear();
+	_meshes.clear();
+}
+
+size_t VectorTessCache::size() const {
+	std::unique_lock lock(_mutex);
+	return _meshes.size();
+}
+
+uint64_t VectorTessCache::getHash(const VectorPath &path) {
+	auto it = _hashes.find(&path);
+	if (it != _hashes.end()) {
+		it->second.generation = _generation;
+		return it->second.hash;
+	}
+
+	auto hash = VectorTess_hash(path);
+	_hashes.emplace(&path,
+			PathEntry{Rc<VectorPath>(const_cast<VectorPath *>(&path)), hash, _generation});
+	return hash;
+}
+
+} // namespace stappler::vg
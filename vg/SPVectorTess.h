@@ -0,0 +1,144 @@
+/**
+ Copyright (c) 2025 Stappler LLC <admin@stappler.dev>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ **/
+
+#ifndef STAPPLER_VG_SPVECTORTESS_H_
+#define STAPPLER_VG_SPVECTORTESS_H_
+
+#include "SPVectorImage.h"
+
+namespace STAPPLER_VERSIONIZED stappler::thread {
+
+class ThreadPool;
+
+}
+
+namespace STAPPLER_VERSIONIZED stappler::vg {
+
+struct SP_PUBLIC VectorTessConfig {
+	// maximum allowed distance (in target pixels) between curve and its approximation
+	float quality = 0.75f;
+
+	// width of antialiasing border (in target pixels) for paths with isAntialiased flag
+	float antialiasValue = 0.5f;
+};
+
+struct SP_PUBLIC VectorTessVertex {
+	Vec2 pos;
+	Vec2 norm;
+	float value = 1.0f; // antialiasing intensity
+};
+
+// Tesselated geometry of a single path in target coordinates
+// Colors are not included, so mesh can be shared between paths with same geometry
+class SP_PUBLIC VectorTessMesh : public Ref {
+public:
+	struct Buffer {
+		Interface::VectorType<VectorTessVertex> vertexes;
+		Interface::VectorType<uint32_t> indexes;
+
+		bool empty() const { return indexes.empty(); }
+	};
+
+	virtual ~VectorTessMesh() = default;
+
+	Buffer fill;
+	Buffer stroke;
+};
+
+struct SP_PUBLIC VectorTessDrawItem {
+	Rc<VectorTessMesh> mesh;
+	Color4F fillColor;
+	Color4F strokeColor;
+
+	// points into source VectorImageData
+	StringView id;
+	StringView cacheId;
+};
+
+// Tesselates single path with transform (path's own transform is applied after `transform`)
+SP_PUBLIC Rc<VectorTessMesh> tessellate(const VectorPath &, const Mat4 &transform,
+		const VectorTessConfig & = VectorTessConfig());
+
+// Cache for tesselated paths, keyed by path content hash, full transform and config
+//
+// Paths in VectorImageData from VectorImage::popData are immutable snapshots: VectorPathRef
+// copies path on write, so content hash is computed once per path object, and modified path
+// gets new hash automatically. For live data (VectorImageData::isSnapshot is false) path can
+// be modified in place, so hash is computed on every call.
+// Identical paths from different images share one mesh.
+//
+// Cache is thread-safe, one cache can be used for multiple images.
+class SP_PUBLIC VectorTessCache : public Ref {
+public:
+	virtual ~VectorTessCache() = default;
+
+	bool init();
+
+	// Tesselates paths of image in draw order, final transform for each path is
+	// transform * viewBoxTransform * PathXRef::mat * path transform
+	// Missed paths are tesselated in parallel on pool (requires stappler_threads module)
+	Interface::VectorType<VectorTessDrawItem> tessellate(const VectorImageData &,
+			const Mat4 &transform, const VectorTessConfig & = VectorTessConfig(),
+			thread::ThreadPool * = nullptr);
+
+	Rc<VectorTessMesh> tessellate(const VectorPath &, const Mat4 &transform,
+			const VectorTessConfig & = VectorTessConfig());
+
+	// Drops entries, that was not used since previous call (call it once per frame)
+	void sweep();
+
+	void clear();
+
+	size_t size() const;
+
+protected:
+	struct Key {
+		uint64_t hash = 0;
+		Mat4 transform;
+		float quality = 0.0f;
+		float antialiasValue = 0.0f;
+
+		bool operator<(const Key &) const;
+	};
+
+	struct PathEntry {
+		Rc<VectorPath> path; // keeps path object (and pointer as map key) alive
+		uint64_t hash = 0;
+		uint64_t generation = 0;
+	};
+
+	struct MeshEntry {
+		Rc<VectorTessMesh> mesh;
+		uint64_t generation = 0;
+	};
+
+	uint64_t getHash(const VectorPath &);
+
+	mutable std::mutex _mutex;
+	uint64_t _generation = 0;
+	Interface::MapType<const VectorPath *, PathEntry> _hashes;
+	Interface::MapType<Key, MeshEntry> _meshes;
+};
+
+} // namespace stappler::vg
+
+#endif /* STAPPLER_VG_SPVECTORTESS_H_ */
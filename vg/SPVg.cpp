@@ -43,3 +43,4 @@ SP_VG_OPTIMIZE
 #include "SPVectorPath.cc"
 #include "SPSvgReader.cc"
 #include "SPVectorImage.cc"
+#include "SPVectorTess.cc"
@@ -24,6 +24,7 @@
 #include "SPZip.h"
 #include "SPLog.h"
 #include "zip.h"
+#include <zlib.h>
 
 #ifdef MODULE_STAPPLER_FILESYSTEM
 #include "SPFilesystem.h"
@@ -31,8 +32,357 @@
 
 namespace STAPPLER_VERSIONIZED stappler {
 
+static constexpr uint32_t ZipLocalHeaderSig = 0x04034b50;
+static constexpr uint32_t ZipCentralHeaderSig = 0x02014b50;
+static constexpr uint32_t ZipEndOfDirSig = 0x06054b50;
+static constexpr uint32_t ZipEndOfDir64Sig = 0x06064b50;
+static constexpr uint32_t ZipEndOfDir64LocatorSig = 0x07064b50;
+
+static constexpr uint16_t ZipFlagEncrypted = 1 << 0;
+static constexpr uint16_t ZipFlagUtf8 = 1 << 11;
+
+static constexpr uint16_t ZipMethodStore = 0;
+static constexpr uint16_t ZipMethodDeflate = 8;
+
+using ZipBytesView = BytesViewTemplate<Endian::Little>;
+
+static bool _isZipEntryDirect(const ZipEntry &entry) {
+	return (entry.flags & ZipFlagEncrypted) == 0
+			&& (entry.method == ZipMethodStore
+					|| (entry.method == ZipMethodDeflate
+							&& entry.compressedSize <= maxOf<uInt>()
+							&& entry.size <= maxOf<uInt>()));
+}
+
+static Time _getZipEntryTime(const ZipEntry &entry) {
+	// same conversion as in libzip: DOS time is a local time
+	struct tm tm;
+	memset(&tm, 0, sizeof(tm));
+	tm.tm_isdst = -1;
+	tm.tm_year = ((entry.dosDate >> 9) & 127) + 1'980 - 1'900;
+	tm.tm_mon = ((entry.dosDate >> 5) & 15) - 1;
+	tm.tm_mday = entry.dosDate & 31;
+	tm.tm_hour = (entry.dosTime >> 11) & 31;
+	tm.tm_min = (entry.dosTime >> 5) & 63;
+	tm.tm_sec = (entry.dosTime << 1) & 62;
+	return Time::seconds(mktime(&tm));
+}
+
+// Reads central directory into flat index; returns false, if archive can not be indexed in the same way as libzip does
+// (multi-disk archives, names in legacy encodings, malformed data), `direct` is false when libzip is required to read some entries
+template <typename Interface>
+static bool _readZipIndex(BytesView data, typename Interface::template VectorType<ZipEntry> &entries,
+		typename Interface::template VectorType<uint32_t> &sorted, bool &direct) {
+	static constexpr size_t EndOfDirSize = 22;
+	static constexpr size_t EndOfDir64LocatorSize = 20;
+	static constexpr size_t CentralHeaderSize = 46;
+
+	if (data.size() < EndOfDirSize) {
+		return false;
+	}
+
+	// end of central directory record is followed by comment up to 64KiB
+	size_t eocd = data.size() - EndOfDirSize;
+	size_t eocdLimit = (eocd > 0xFFFF) ? eocd - 0xFFFF : 0;
+	while (ZipBytesView(data.data() + eocd, 4).readUnsigned32() != ZipEndOfDirSig) {
+		if (eocd == eocdLimit) {
+			return false;
+		}
+		--eocd;
+	}
+
+	ZipBytesView r(data.data() + eocd + 4, EndOfDirSize - 4);
+	auto disk = r.readUnsigned16();
+	auto cdDisk = r.readUnsigned16();
+	r += 2; // entries on this disk
+	uint64_t count = r.readUnsigned16();
+	uint64_t cdSize = r.readUnsigned32();
+	uint64_t cdOffset = r.readUnsigned32();
+
+	if (count == 0xFFFF || cdSize == 0xFFFF'FFFF || cdOffset == 0xFFFF'FFFF) {
+		if (eocd < EndOfDir64LocatorSize) {
+			return false;
+		}
+
+		ZipBytesView loc(data.data() + eocd - EndOfDir64LocatorSize, EndOfDir64LocatorSize);
+		if (loc.readUnsigned32() != ZipEndOfDir64LocatorSig) {
+			return false;
+		}
+		loc += 4; // disk with zip64 record
+		auto eocd64 = loc.readUnsigned64();
+		if (eocd64 > data.size() || data.size() - eocd64 < 56) {
+			return false;
+		}
+
+		ZipBytesView r64(data.data() + eocd64, 56);
+		if (r64.readUnsigned32() != ZipEndOfDir64Sig) {
+			return false;
+		}
+		r64 += 8 + 2 + 2; // record size, versions
+		disk = r64.readUnsigned32();
+		cdDisk = r64.readUnsigned32();
+		r64 += 8; // entries on this disk
+		count = r64.readUnsigned64();
+		cdSize = r64.readUnsigned64();
+		cdOffset = r64.readUnsigned64();
+	}
+
+	if (disk != 0 || cdDisk != 0 || cdOffset > data.size() || data.size() - cdOffset < cdSize
+			|| count > cdSize / CentralHeaderSize) {
+		return false;
+	}
+
+	entries.reserve(count);
+
+	direct = true;
+	ZipBytesView cd(data.data() + cdOffset, cdSize);
+	for (uint64_t i = 0; i < count; ++i) {
+		if (cd.size() < CentralHeaderSize || cd.readUnsigned32() != ZipCentralHeaderSig) {
+			return false;
+		}
+
+		ZipEntry entry;
+		cd += 4; // versions
+		entry.flags = cd.readUnsigned16();
+		entry.method = cd.readUnsigned16();
+		entry.dosTime = cd.readUnsigned16();
+		entry.dosDate = cd.readUnsigned16();
+		cd += 4; // crc32
+		entry.compressedSize = cd.readUnsigned32();
+		entry.size = cd.readUnsigned32();
+		auto nameLen = cd.readUnsigned16();
+		auto extraLen = cd.readUnsigned16();
+		auto commentLen = cd.readUnsigned16();
+		auto startDisk = cd.readUnsigned16();
+		cd += 2 + 4; // attributes
+		entry.offset = cd.readUnsigned32();
+
+		if (cd.size() < size_t(nameLen) + extraLen + commentLen) {
+			return false;
+		}
+
+		entry.name = cd.readBytes(nameLen).toStringView();
+		auto extra = cd.readBytes<Endian::Little>(extraLen);
+		cd += commentLen;
+
+		if ((entry.flags & ZipFlagUtf8) == 0) {
+			for (auto c : entry.name) {
+				if (uint8_t(c) >= 0x80) {
+					// libzip guesses encoding for this name, so results can differ
+					return false;
+				}
+			}
+		}
+
+		// zip64 extended information: only fields, that overflowed in header, are present
+		while (extra.size() >= 4) {
+			auto id = extra.readUnsigned16();
+			auto len = extra.readUnsigned16();
+			if (extra.size() < len) {
+				return false;
+			}
+
+			auto field = extra.readBytes<Endian::Little>(len);
+			if (id == 0x0001) {
+				if (entry.size == 0xFFFF'FFFF) {
+					if (field.size() < 8) {
+						return false;
+					}
+					entry.size = field.readUnsigned64();
+				}
+				if (entry.compressedSize == 0xFFFF'FFFF) {
+					if (field.size() < 8) {
+						return false;
+					}
+					entry.compressedSize = field.readUnsigned64();
+				}
+				if (entry.offset == 0xFFFF'FFFF) {
+					if (field.size() < 8) {
+						return false;
+					}
+					entry.offset = field.readUnsigned64();
+				}
+				if (startDisk == 0xFFFF && field.size() >= 4) {
+					startDisk = field.readUnsigned32();
+				}
+			}
+		}
+
+		if (startDisk != 0 || entry.offset >= data.size()) {
+			return false;
+		}
+
+		if (!_isZipEntryDirect(entry)) {
+			direct = false;
+		}
+
+		entries.emplace_back(entry);
+	}
+
+	sorted.resize(entries.size());
+	for (uint32_t i = 0; i < sorted.size(); ++i) { sorted[i] = i; }
+
+	// stable, so first of duplicated names is found, as with zip_name_locate
+	std::stable_sort(sorted.begin(), sorted.end(),
+			[&](uint32_t l, uint32_t r) { return entries[l].name < entries[r].name; });
+
+	return true;
+}
+
+template <typename Interface>
+static uint64_t _locateZipEntry(const typename Interface::template VectorType<ZipEntry> &entries,
+		const typename Interface::template VectorType<uint32_t> &sorted, StringView path) {
+	auto it = std::lower_bound(sorted.begin(), sorted.end(), path,
+			[&](uint32_t l, StringView r) { return entries[l].name < r; });
+	if (it != sorted.end() && entries[*it].name == path) {
+		return *it;
+	}
+	return maxOf<uint64_t>();
+}
+
+static bool _readFile(zip_t *handle, uint64_t index, const Callback<void(BytesView)> &cb);
+
+template <typename Bytes>
+static bool _readMappedFile(BytesView data, const ZipEntry &entry, Bytes &buf, zip_t *handle,
+		uint64_t index, const Callback<void(BytesView)> &cb) {
+	static constexpr size_t LocalHeaderSize = 30;
+
+	if (entry.size == 0) {
+		return false;
+	}
+
+	if (!_isZipEntryDirect(entry)) {
+		return handle ? _readFile(handle, index, cb) : false;
+	}
+
+	if (data.size() - entry.offset < LocalHeaderSize) {
+		return false;
+	}
+
+	// local header can have extra field, that differs from central directory
+	ZipBytesView r(data.data() + entry.offset, LocalHeaderSize);
+	if (r.readUnsigned32() != ZipLocalHeaderSig) {
+		return false;
+	}
+	r += 22;
+	auto nameLen = r.readUnsigned16();
+	auto extraLen = r.readUnsigned16();
+
+	auto dataOffset = entry.offset + LocalHeaderSize + nameLen + extraLen;
+	if (dataOffset > data.size() || data.size() - dataOffset < entry.compressedSize) {
+		return false;
+	}
+
+	auto source = data.data() + dataOffset;
+	if (entry.method == ZipMethodStore) {
+		if (entry.compressedSize != entry.size) {
+			return false;
+		}
+		cb(BytesView(source, entry.size));
+		return true;
+	}
+
+	if (buf.size() < entry.size) {
+		buf.resize(entry.size);
+	}
+
+	// sizes are known from central directory, so whole stream is inflated with single call
+	z_stream stream;
+	memset(&stream, 0, sizeof(z_stream));
+	if (inflateInit2(&stream, -MAX_WBITS) != Z_OK) {
+		return false;
+	}
+
+	stream.next_in = const_cast<Bytef *>(source);
+	stream.avail_in = uInt(entry.compressedSize);
+	stream.next_out = buf.data();
+	stream.avail_out = uInt(entry.size);
+
+	auto ret = ::inflate(&stream, Z_FINISH);
+	auto total = stream.total_out;
+	inflateEnd(&stream);
+
+	if (ret != Z_STREAM_END || total != entry.size) {
+		log::source().warn("ZipArchive", "Fail to inflate file: ", entry.name);
+		return false;
+	}
+
+	cb(BytesView(buf.data(), entry.size));
+	return true;
+}
+
 #ifdef MODULE_STAPPLER_FILESYSTEM
 
+template <typename Interface>
+static bool _createMappedZipArchive(const FileInfo &info, ZipBuffer<Interface> *d,
+		BytesView &mapped, typename Interface::template VectorType<ZipEntry> &entries,
+		typename Interface::template VectorType<uint32_t> &sorted, zip_t *&handle) {
+	if (hasFlag(filesystem::getCategoryFlags(info.category),
+				filesystem::CategoryFlags::PlatformSpecific)) {
+		return false;
+	}
+
+	auto region = filesystem::MemoryMappedRegion::mapFile(info, filesystem::MappingType::Private,
+			filesystem::ProtFlags::MapRead);
+	if (!region || region.getSize() < 4) {
+		return false;
+	}
+
+	auto view = region.getView();
+	if (memcmp(view.data(), ZipArchive<Interface>::ZIP_SIG1, 4) != 0
+			&& memcmp(view.data(), ZipArchive<Interface>::ZIP_SIG2, 4) != 0
+			&& memcmp(view.data(), ZipArchive<Interface>::ZIP_SIG3, 4) != 0) {
+		return false;
+	}
+
+	bool direct = true;
+	if (!_readZipIndex<Interface>(view, entries, sorted, direct)) {
+		entries.clear();
+		sorted.clear();
+		return false;
+	}
+
+	if (!direct) {
+		// some entries are encrypted or compressed with other methods, read them with libzip,
+		// that uses the same mapping as a source
+		zip_error_t err;
+		zip_error_init(&err);
+		auto source = zip_source_buffer_create(view.data(), view.size(), 0, &err);
+		if (source) {
+			handle = zip_open_from_source(source, ZIP_RDONLY, &err);
+			if (!handle) {
+				zip_source_free(source);
+			}
+		}
+		zip_error_fini(&err);
+
+		if (!handle) {
+			entries.clear();
+			sorted.clear();
+			return false;
+		}
+	}
+
+	size_t size = sizeof(filesystem::MemoryMappedRegion) + alignof(filesystem::MemoryMappedRegion) * 2;
+
+	d->data = BufferTemplate<Interface>(size);
+
+	auto ptr = d->data.prepare(size);
+	auto target = (void *)math::align(uintptr_t(ptr),
+			uintptr_t(alignof(filesystem::MemoryMappedRegion)));
+
+	d->readonly = true;
+	d->handle = new (target) filesystem::MemoryMappedRegion(move(region));
+	d->finalize = [](void *ptr) {
+		auto region = (filesystem::MemoryMappedRegion *)ptr;
+		region->~MemoryMappedRegion();
+	};
+
+	mapped = view;
+	return true;
+}
+
+
 template <typename Interface>
 static zip_t *_createZipArchive(FileInfo info, ZipBuffer<Interface> *d) {
 	size_t size = sizeof(filesystem::File) + alignof(filesystem::File) * 2;
@@ -137,12 +487,16 @@ static zip_t *_createZipArchive(FileInfo info, ZipBuffer<Interface> *d) {
 
 template <>
 ZipArchive<memory::StandartInterface>::ZipArchive(FileInfo info) {
-	_handle = _createZipArchive(info, &_data);
+	if (!_createMappedZipArchive(info, &_data, _mapped, _entries, _sortedEntries, _handle)) {
+		_handle = _createZipArchive(info, &_data);
+	}
 }
 
 template <>
 ZipArchive<memory::PoolInterface>::ZipArchive(FileInfo info) {
-	_handle = _createZipArchive(info, &_data);
+	if (!_createMappedZipArchive(info, &_data, _mapped, _entries, _sortedEntries, _handle)) {
+		_handle = _createZipArchive(info, &_data);
+	}
 }
 
 #endif
@@ -266,6 +620,10 @@ static zip_t *_createZipArchive(FILE *file, bool readonly) {
 
 template <typename Interface>
 static bool addFileToArchive(zip_t *_handle, StringView name, BytesView data, bool uncompressed) {
+	if (!_handle) {
+		return false;
+	}
+
 	zip_source_t *source = nullptr;
 	uint8_t *buf = nullptr;
 
@@ -347,6 +705,9 @@ ZipArchive<memory::PoolInterface>::~ZipArchive() {
 
 template <>
 bool ZipArchive<memory::StandartInterface>::addDir(StringView name) {
+	if (!_handle) {
+		return false;
+	}
 	return zip_dir_add(_handle,
 				   name.terminated() ? name.data() : name.str<memory::StandartInterface>().data(),
 				   ZIP_FL_ENC_UTF_8)
@@ -355,6 +716,9 @@ bool ZipArchive<memory::StandartInterface>::addDir(StringView name) {
 
 template <>
 bool ZipArchive<memory::PoolInterface>::addDir(StringView name) {
+	if (!_handle) {
+		return false;
+	}
 	return zip_dir_add(_handle,
 				   name.terminated() ? name.data() : name.str<memory::PoolInterface>().data(),
 				   ZIP_FL_ENC_UTF_8)
@@ -405,16 +769,26 @@ auto ZipArchive<memory::PoolInterface>::save() -> BufferTemplate<memory::PoolInt
 
 template <>
 size_t ZipArchive<memory::StandartInterface>::size(bool original) const {
+	if (!_mapped.empty()) {
+		return _entries.size();
+	}
 	return zip_get_num_entries(_handle, original ? ZIP_FL_UNCHANGED : 0);
 }
 
 template <>
 size_t ZipArchive<memory::PoolInterface>::size(bool original) const {
+	if (!_mapped.empty()) {
+		return _entries.size();
+	}
 	return zip_get_num_entries(_handle, original ? ZIP_FL_UNCHANGED : 0);
 }
 
 template <>
 uint64_t ZipArchive<memory::StandartInterface>::locateFile(StringView path) const {
+	if (!_mapped.empty()) {
+		return _locateZipEntry<memory::StandartInterface>(_entries, _sortedEntries, path);
+	}
+
 	auto ret = zip_name_locate(_handle,
 			path.terminated() ? path.data() : path.str<memory::StandartInterface>().data(),
 			ZIP_FL_ENC_GUESS);
@@ -426,6 +800,10 @@ uint64_t ZipArchive<memory::StandartInterface>::locateFile(StringView path) cons
 
 template <>
 uint64_t ZipArchive<memory::PoolInterface>::locateFile(StringView path) const {
+	if (!_mapped.empty()) {
+		return _locateZipEntry<memory::PoolInterface>(_entries, _sortedEntries, path);
+	}
+
 	auto ret = zip_name_locate(_handle,
 			path.terminated() ? path.data() : path.str<memory::StandartInterface>().data(),
 			ZIP_FL_ENC_GUESS);
@@ -440,6 +818,9 @@ StringView ZipArchive<memory::StandartInterface>::getFileName(uint64_t idx, bool
 	if (idx == maxOf<uint64_t>()) {
 		return StringView();
 	}
+	if (!_mapped.empty()) {
+		return (idx < _entries.size()) ? _entries[idx].name : StringView();
+	}
 	return zip_get_name(_handle, idx,
 			original ? ZIP_FL_UNCHANGED | ZIP_FL_ENC_GUESS : ZIP_FL_ENC_GUESS);
 }
@@ -449,6 +830,9 @@ StringView ZipArchive<memory::PoolInterface>::getFileName(uint64_t idx, bool ori
 	if (idx == maxOf<uint64_t>()) {
 		return StringView();
 	}
+	if (!_mapped.empty()) {
+		return (idx < _entries.size()) ? _entries[idx].name : StringView();
+	}
 	return zip_get_name(_handle, idx,
 			original ? ZIP_FL_UNCHANGED | ZIP_FL_ENC_GUESS : ZIP_FL_ENC_GUESS);
 }
@@ -457,6 +841,12 @@ template <>
 void ZipArchive<memory::StandartInterface>::ftw(
 		const Callback<void(uint64_t, StringView path, size_t size, Time time)> &cb,
 		bool original) const {
+	if (!_mapped.empty()) {
+		uint64_t i = 0;
+		for (auto &it : _entries) { cb(i++, it.name, it.size, _getZipEntryTime(it)); }
+		return;
+	}
+
 	zip_stat_t stat;
 	for (uint64_t i = 0; i < size(original); ++i) {
 		zip_stat_index(_handle, i, ZIP_STAT_SIZE | ZIP_STAT_MTIME | ZIP_STAT_NAME, &stat);
@@ -468,6 +858,12 @@ template <>
 void ZipArchive<memory::PoolInterface>::ftw(
 		const Callback<void(uint64_t, StringView path, size_t size, Time time)> &cb,
 		bool original) const {
+	if (!_mapped.empty()) {
+		uint64_t i = 0;
+		for (auto &it : _entries) { cb(i++, it.name, it.size, _getZipEntryTime(it)); }
+		return;
+	}
+
 	zip_stat_t stat;
 	for (uint64_t i = 0; i < size(original); ++i) {
 		zip_stat_index(_handle, i, ZIP_STAT_SIZE | ZIP_STAT_MTIME | ZIP_STAT_NAME, &stat);
@@ -523,24 +919,42 @@ static bool _readFile(zip_t *handle, StringView path, const Callback<void(BytesV
 template <>
 bool ZipArchive<memory::StandartInterface>::readFile(StringView name,
 		const Callback<void(BytesView)> &cb) const {
+	if (!_mapped.empty()) {
+		return readFile(_locateZipEntry<memory::StandartInterface>(_entries, _sortedEntries, name), cb);
+	}
 	return _readFile(_handle, name, cb);
 }
 
 template <>
 bool ZipArchive<memory::StandartInterface>::readFile(uint64_t index,
 		const Callback<void(BytesView)> &cb) const {
+	if (!_mapped.empty()) {
+		if (index >= _entries.size()) {
+			return false;
+		}
+		return _readMappedFile(_mapped, _entries[index], _inflateBuffer, _handle, index, cb);
+	}
 	return _readFile(_handle, index, cb);
 }
 
 template <>
 bool ZipArchive<memory::PoolInterface>::readFile(StringView name,
 		const Callback<void(BytesView)> &cb) const {
+	if (!_mapped.empty()) {
+		return readFile(_locateZipEntry<memory::PoolInterface>(_entries, _sortedEntries, name), cb);
+	}
 	return _readFile(_handle, name, cb);
 }
 
 template <>
 bool ZipArchive<memory::PoolInterface>::readFile(uint64_t index,
 		const Callback<void(BytesView)> &cb) const {
+	if (!_mapped.empty()) {
+		if (index >= _entries.size()) {
+			return false;
+		}
+		return _readMappedFile(_mapped, _entries[index], _inflateBuffer, _handle, index, cb);
+	}
 	return _readFile(_handle, index, cb);
 }
 
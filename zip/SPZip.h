@@ -27,6 +27,7 @@ THE SOFTWARE.
 #include "SPBytesView.h" // IWYU pragma: keep
 #include "SPBuffer.h"
 #include "SPTime.h"
+#include "SPIO.h"
 
 #ifdef MODULE_STAPPLER_FILESYSTEM
 #include "SPFilepath.h"
@@ -34,6 +35,12 @@ THE SOFTWARE.
 
 typedef struct zip zip_t;
 
+namespace STAPPLER_VERSIONIZED stappler::thread {
+
+class ThreadPool;
+
+}
+
 namespace STAPPLER_VERSIONIZED stappler {
 
 template <typename Interface>
@@ -48,6 +55,18 @@ struct ZipBuffer {
 	Buffer buffer;
 };
 
+// Central directory entry for direct reads from memory-mapped archive
+struct ZipEntry {
+	StringView name; // points into mapped central directory
+	uint64_t offset = 0; // local header offset
+	uint64_t compressedSize = 0;
+	uint64_t size = 0;
+	uint16_t method = 0;
+	uint16_t flags = 0;
+	uint16_t dosTime = 0;
+	uint16_t dosDate = 0;
+};
+
 template <typename Interface>
 class SP_PUBLIC ZipArchive : public Interface::AllocBaseType {
 public:
@@ -63,6 +82,9 @@ public:
 	ZipArchive(FILE *, bool readonly);
 
 #ifdef MODULE_STAPPLER_FILESYSTEM
+	// Archive in native filesystem is memory-mapped and indexed directly, without libzip:
+	// STORED files are read without copying, DEFLATE files are inflated into reusable buffer
+	// (so, data in readFile callback is valid only until next readFile call)
 	ZipArchive(FileInfo);
 #endif
 
@@ -74,7 +96,7 @@ public:
 
 	Buffer save();
 
-	explicit operator bool() { return _handle != nullptr; }
+	explicit operator bool() { return _handle != nullptr || !_mapped.empty(); }
 
 	size_t size(bool original = false) const;
 
@@ -92,6 +114,66 @@ public:
 protected:
 	ZipBuffer<Interface> _data;
 	zip_t *_handle = nullptr;
+
+	// for mapped archive, _handle is opened only when some entries can not be read directly
+	BytesView _mapped;
+	typename Interface::template VectorType<ZipEntry> _entries;
+	typename Interface::template VectorType<uint32_t> _sortedEntries;
+	mutable Bytes _inflateBuffer;
+};
+
+// Streaming archive writer: entries are compressed with independent deflate streams (in parallel,
+// when thread pool is provided) and written to output in order of addition, as soon as they are ready;
+// central directory is written on finalize. Memory is bounded by window of entries in flight.
+//
+// Writer methods should be called from a single thread
+class SP_PUBLIC ZipWriter final {
+public:
+	static constexpr size_t DefaultWindowSize = 64 * 1'024 * 1'024;
+
+	struct Config {
+		// writer compresses entry by itself, when pool has not started it yet, so the pool can be
+		// busy, stopped, or the one, that writer is called from
+		thread::ThreadPool *threadPool = nullptr;
+
+		// max size of uncompressed data for entries, that are not written yet;
+		// single entry larger then window is still accepted, when nothing else is in flight
+		size_t windowSize = DefaultWindowSize;
+
+		// zlib compression level, -1 for default
+		int level = -1;
+	};
+
+	ZipWriter(const io::Consumer &);
+	ZipWriter(const io::Consumer &, const Config &);
+
+	ZipWriter(FILE *);
+	ZipWriter(FILE *, const Config &);
+
+	// finalizes archive, if it was not finalized explicitly
+	~ZipWriter();
+
+	ZipWriter(const ZipWriter &) = delete;
+	ZipWriter &operator=(const ZipWriter &) = delete;
+
+	bool addDir(StringView name, Time mtime = Time::now());
+	bool addFile(StringView name, BytesView data, bool uncompressed = false,
+			Time mtime = Time::now());
+	bool addFile(StringView name, StringView data, bool uncompressed = false,
+			Time mtime = Time::now());
+
+	// waits for all entries and writes central directory
+	bool finalize();
+
+	// false after any write error
+	explicit operator bool() const;
+
+	uint64_t getWrittenSize() const;
+
+protected:
+	struct Data;
+
+	Data *_data = nullptr;
 };
 
 template <typename Interface>
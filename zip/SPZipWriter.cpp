@@ -0,0 +1,514 @@
+/**
+ Copyright (c) 2025 Stappler LLC <admin@stappler.dev>
+
+ Permission is hereby granted, free of charge, to any person obtaining a copy
+ of this software and associated documentation files (the "Software"), to deal
+ in the Software without restriction, including without limitation the rights
+ to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ copies of the Software, and to permit persons to whom the Software is
+ furnished to do so, subject to the following conditions:
+
+ The above copyright notice and this permission notice shall be included in
+ all copies or substantial portions of the Software.
+
+ THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ THE SOFTWARE.
+ **/
+
+#include "SPCommon.h" // IWYU pragma: keep
+#include "SPZip.h"
+#include "SPLog.h"
+#include <zlib.h>
+
+#if MODULE_STAPPLER_THREADS
+#include "SPThreadPool.h"
+#endif
+
+namespace STAPPLER_VERSIONIZED stappler {
+
+static constexpr uint32_t ZipWriterLocalHeaderSig = 0x04034b50;
+static constexpr uint32_t ZipWriterCentralHeaderSig = 0x02014b50;
+static constexpr uint32_t ZipWriterEndOfDirSig = 0x06054b50;
+static constexpr uint32_t ZipWriterEndOfDir64Sig = 0x06064b50;
+static constexpr uint32_t ZipWriterEndOfDir64LocatorSig = 0x07064b50;
+
+static constexpr uint16_t ZipWriterVersion = 20;
+static constexpr uint16_t ZipWriterVersion64 = 45;
+static constexpr uint16_t ZipWriterMadeBy = (3 << 8) | 45; // unix
+
+static constexpr uint16_t ZipWriterFlagUtf8 = 1 << 11;
+
+static constexpr uint32_t ZipWriterFileAttributes = uint32_t(0100'644) << 16;
+static constexpr uint32_t ZipWriterDirAttributes = (uint32_t(0040'755) << 16) | 0x10; // with MS-DOS directory bit
+
+static constexpr uint64_t ZipWriterMax32 = 0xFFFF'FFFF;
+static constexpr uint64_t ZipWriterMax16 = 0xFFFF;
+
+// entries smaller then this are compressed on writer's thread, task overhead is larger then compression
+static constexpr size_t ZipWriterMinParallelSize = 16 * 1'024;
+
+using ZipWriterBytes = memory::StandartInterface::BytesType;
+
+static void ZipWriter_put16(ZipWriterBytes &buf, uint16_t v) {
+	buf.emplace_back(uint8_t(v));
+	buf.emplace_back(uint8_t(v >> 8));
+}
+
+static void ZipWriter_put32(ZipWriterBytes &buf, uint32_t v) {
+	ZipWriter_put16(buf, uint16_t(v));
+	ZipWriter_put16(buf, uint16_t(v >> 16));
+}
+
+static void ZipWriter_put64(ZipWriterBytes &buf, uint64_t v) {
+	ZipWriter_put32(buf, uint32_t(v));
+	ZipWriter_put32(buf, uint32_t(v >> 32));
+}
+
+static void ZipWriter_putName(ZipWriterBytes &buf, StringView name) {
+	buf.insert(buf.end(), (const uint8_t *)name.data(), (const uint8_t *)name.data() + name.size());
+}
+
+struct ZipWriterEntry : public Ref {
+	memory::StandartInterface::StringType name;
+	uint16_t flags = 0;
+	uint16_t method = 0;
+	uint16_t dosTime = 0;
+	uint16_t dosDate = 0;
+	uint32_t crc = 0;
+	bool isDir = false;
+	bool uncompressed = false;
+	int level = -1;
+
+	uint64_t size = 0;
+
+	ZipWriterBytes input;
+	ZipWriterBytes output; // empty for stored entries, data is in input
+
+	// entry is compressed by the one, who claimed it first: pool's task or writer itself,
+	// so writer never waits for task, that was not started (or will never be started)
+	std::atomic<bool> claimed = false;
+	std::atomic<bool> completed = false;
+
+	bool claim() { return !claimed.exchange(true, std::memory_order_acq_rel); }
+
+	BytesView getData() const {
+		return (method == Z_DEFLATED) ? BytesView(output.data(), output.size())
+									  : BytesView(input.data(), input.size());
+	}
+
+	void compress() {
+		size = input.size();
+		crc = ::crc32(0, nullptr, 0);
+		for (size_t offset = 0; offset < input.size();) {
+			auto chunk = std::min(input.size() - offset, size_t(maxOf<uInt>()));
+			crc = ::crc32(crc, input.data() + offset, uInt(chunk));
+			offset += chunk;
+		}
+
+		method = 0;
+		if (uncompressed || input.empty()) {
+			return;
+		}
+
+		z_stream stream;
+		memset(&stream, 0, sizeof(z_stream));
+		if (deflateInit2(&stream, level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+			return;
+		}
+
+		output.resize(deflateBound(&stream, uLong(input.size())));
+
+		auto in = input.data();
+		auto inRemains = input.size();
+		auto out = output.data();
+		auto outRemains = output.size();
+
+		int ret = Z_OK;
+		do {
+			auto inChunk = std::min(inRemains, size_t(maxOf<uInt>()));
+			auto outChunk = std::min(outRemains, size_t(maxOf<uInt>()));
+
+			stream.next_in = in;
+			stream.avail_in = uInt(inChunk);
+			stream.next_out = out;
+			stream.avail_out = uInt(outChunk);
+
+			ret = ::deflate(&stream, (inChunk == inRemains) ? Z_FINISH : Z_NO_FLUSH);
+
+			in += inChunk - stream.avail_in;
+			inRemains -= inChunk - stream.avail_in;
+			out += outChunk - stream.avail_out;
+			outRemains -= outChunk - stream.avail_out;
+		} while (ret == Z_OK);
+
+		deflateEnd(&stream);
+
+		// incompressible data is stored as is
+		auto compressedSize = output.size() - outRemains;
+		if (ret != Z_STREAM_END || compressedSize >= input.size()) {
+			output = ZipWriterBytes();
+			return;
+		}
+
+		method = Z_DEFLATED;
+		output.resize(compressedSize);
+		input = ZipWriterBytes();
+	}
+};
+
+struct ZipWriterCentralRecord {
+	memory::StandartInterface::StringType name;
+	uint16_t flags = 0;
+	uint16_t method = 0;
+	uint16_t dosTime = 0;
+	uint16_t dosDate = 0;
+	uint32_t crc = 0;
+	bool isDir = false;
+	uint64_t compressedSize = 0;
+	uint64_t size = 0;
+	uint64_t offset = 0;
+};
+
+struct ZipWriterSync : public Ref {
+	std::mutex mutex;
+	std::condition_variable cond;
+};
+
+struct ZipWriter::Data {
+	std::optional<io::Consumer> consumer;
+	FILE *file = nullptr;
+	Config config;
+
+	Rc<ZipWriterSync> sync = Rc<ZipWriterSync>::alloc();
+
+	std::deque<Rc<ZipWriterEntry>> pending;
+	size_t inFlight = 0;
+
+	memory::StandartInterface::VectorType<ZipWriterCentralRecord> records;
+	uint64_t offset = 0;
+
+	bool failed = false;
+	bool finalized = false;
+
+	Data(const io::Consumer &c, const Config &cfg) : consumer(c), config(cfg) { }
+	Data(FILE *f, const Config &cfg) : file(f), config(cfg) { }
+
+	bool write(const uint8_t *data, size_t size) {
+		if (failed) {
+			return false;
+		}
+
+		size_t written = 0;
+		if (file) {
+			written = ::fwrite(data, 1, size, file);
+		} else {
+			written = consumer->write(data, size);
+		}
+
+		if (written != size) {
+			log::source().error("ZipWriter", "Fail to write archive data");
+			failed = true;
+			return false;
+		}
+
+		offset += size;
+		return true;
+	}
+
+	bool write(BytesView data) { return write(data.data(), data.size()); }
+
+	bool writeEntry(ZipWriterEntry *entry) {
+		auto data = entry->getData();
+		auto zip64 = entry->size >= ZipWriterMax32 || data.size() >= ZipWriterMax32;
+
+		ZipWriterCentralRecord record;
+		record.name = entry->name;
+		record.flags = entry->flags;
+		record.method = entry->method;
+		record.dosTime = entry->dosTime;
+		record.dosDate = entry->dosDate;
+		record.crc = entry->crc;
+		record.isDir = entry->isDir;
+		record.compressedSize = data.size();
+		record.size = entry->size;
+		record.offset = offset;
+
+		ZipWriterBytes header;
+		header.reserve(30 + entry->name.size() + 20);
+
+		ZipWriter_put32(header, ZipWriterLocalHeaderSig);
+		ZipWriter_put16(header, zip64 ? ZipWriterVersion64 : ZipWriterVersion);
+		ZipWriter_put16(header, entry->flags);
+		ZipWriter_put16(header, entry->method);
+		ZipWriter_put16(header, entry->dosTime);
+		ZipWriter_put16(header, entry->dosDate);
+		ZipWriter_put32(header, entry->crc);
+		ZipWriter_put32(header, zip64 ? uint32_t(ZipWriterMax32) : uint32_t(data.size()));
+		ZipWriter_put32(header, zip64 ? uint32_t(ZipWriterMax32) : uint32_t(entry->size));
+		ZipWriter_put16(header, uint16_t(entry->name.size()));
+		ZipWriter_put16(header, zip64 ? 20 : 0);
+		ZipWriter_putName(header, entry->name);
+		if (zip64) {
+			ZipWriter_put16(header, 0x0001);
+			ZipWriter_put16(header, 16);
+			ZipWriter_put64(header, entry->size);
+			ZipWriter_put64(header, data.size());
+		}
+
+		if (!write(BytesView(header)) || !write(data)) {
+			return false;
+		}
+
+		records.emplace_back(move(record));
+		return true;
+	}
+
+	// waits for the oldest entry and writes it
+	bool writeFront() {
+		auto entry = move(pending.front());
+		pending.pop_front();
+
+		if (entry->claim()) {
+			entry->compress();
+			entry->completed.store(true, std::memory_order_release);
+		} else if (!entry->completed.load(std::memory_order_acquire)) {
+			std::unique_lock lock(sync->mutex);
+			sync->cond.wait(lock, [&] { return entry->completed.load(std::memory_order_acquire); });
+		}
+
+		inFlight -= entry->size;
+		return writeEntry(entry);
+	}
+
+	// writes completed entries from the head of queue, or all entries, if `all` is set
+	bool flush(bool all) {
+		while (!pending.empty()) {
+			if (!all && !pending.front()->completed.load(std::memory_order_acquire)) {
+				break;
+			}
+			if (!writeFront()) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	bool add(Rc<ZipWriterEntry> &&entry) {
+		if (failed || finalized) {
+			return false;
+		}
+
+		if (entry->name.empty() || entry->name.size() > ZipWriterMax16) {
+			log::source().error("ZipWriter", "Invalid entry name: ", entry->name);
+			return false;
+		}
+
+		for (auto c : entry->name) {
+			if (uint8_t(c) >= 0x80) {
+				entry->flags |= ZipWriterFlagUtf8;
+				break;
+			}
+		}
+
+		auto size = entry->input.size();
+		while (!pending.empty() && inFlight + size > config.windowSize) {
+			if (!writeFront()) {
+				return false;
+			}
+		}
+
+		inFlight += size;
+
+#if MODULE_STAPPLER_THREADS
+		if (config.threadPool && !entry->uncompressed && size >= ZipWriterMinParallelSize) {
+			// task keeps its own references, so writer can be destroyed before task is finished
+			auto &e = pending.emplace_back(move(entry));
+			auto status = config.threadPool->perform([e, sync = sync] {
+				if (!e->claim()) {
+					return;
+				}
+				e->compress();
+				std::unique_lock lock(sync->mutex);
+				e->completed.store(true, std::memory_order_release);
+				sync->cond.notify_all();
+			}, e);
+			if (status != Status::Ok) {
+				// pool is not running, entry will be compressed by writeFront
+				return flush(true);
+			}
+			return flush(false);
+		}
+#endif
+
+		entry->claim();
+		entry->compress();
+		entry->completed.store(true, std::memory_order_release);
+		pending.emplace_back(move(entry));
+		return flush(false);
+	}
+
+	bool writeCentralDirectory() {
+		auto cdOffset = offset;
+
+		ZipWriterBytes buf;
+		for (auto &it : records) {
+			auto zip64Size = it.size >= ZipWriterMax32 || it.compressedSize >= ZipWriterMax32;
+			auto zip64Offset = it.offset >= ZipWriterMax32;
+
+			buf.clear();
+			ZipWriter_put32(buf, ZipWriterCentralHeaderSig);
+			ZipWriter_put16(buf, ZipWriterMadeBy);
+			ZipWriter_put16(buf, (zip64Size || zip64Offset) ? ZipWriterVersion64 : ZipWriterVersion);
+			ZipWriter_put16(buf, it.flags);
+			ZipWriter_put16(buf, it.method);
+			ZipWriter_put16(buf, it.dosTime);
+			ZipWriter_put16(buf, it.dosDate);
+			ZipWriter_put32(buf, it.crc);
+			ZipWriter_put32(buf, zip64Size ? uint32_t(ZipWriterMax32) : uint32_t(it.compressedSize));
+			ZipWriter_put32(buf, zip64Size ? uint32_t(ZipWriterMax32) : uint32_t(it.size));
+			ZipWriter_put16(buf, uint16_t(it.name.size()));
+			ZipWriter_put16(buf, (zip64Size || zip64Offset) ? (4 + (zip64Size ? 16 : 0) + (zip64Offset ? 8 : 0)) : 0);
+			ZipWriter_put16(buf, 0); // comment
+			ZipWriter_put16(buf, 0); // disk
+			ZipWriter_put16(buf, 0); // internal attributes
+			ZipWriter_put32(buf, it.isDir ? ZipWriterDirAttributes : ZipWriterFileAttributes);
+			ZipWriter_put32(buf, zip64Offset ? uint32_t(ZipWriterMax32) : uint32_t(it.offset));
+			ZipWriter_putName(buf, it.name);
+			if (zip64Size || zip64Offset) {
+				ZipWriter_put16(buf, 0x0001);
+				ZipWriter_put16(buf, (zip64Size ? 16 : 0) + (zip64Offset ? 8 : 0));
+				if (zip64Size) {
+					ZipWriter_put64(buf, it.size);
+					ZipWriter_put64(buf, it.compressedSize);
+				}
+				if (zip64Offset) {
+					ZipWriter_put64(buf, it.offset);
+				}
+			}
+
+			if (!write(BytesView(buf))) {
+				return false;
+			}
+		}
+
+		auto cdSize = offset - cdOffset;
+		auto count = uint64_t(records.size());
+
+		buf.clear();
+		if (count >= ZipWriterMax16 || cdSize >= ZipWriterMax32 || cdOffset >= ZipWriterMax32) {
+			auto eocd64 = offset;
+
+			ZipWriter_put32(buf, ZipWriterEndOfDir64Sig);
+			ZipWriter_put64(buf, 44); // size of remaining record
+			ZipWriter_put16(buf, ZipWriterMadeBy);
+			ZipWriter_put16(buf, ZipWriterVersion64);
+			ZipWriter_put32(buf, 0); // disk
+			ZipWriter_put32(buf, 0); // disk with central directory
+			ZipWriter_put64(buf, count);
+			ZipWriter_put64(buf, count);
+			ZipWriter_put64(buf, cdSize);
+			ZipWriter_put64(buf, cdOffset);
+
+			ZipWriter_put32(buf, ZipWriterEndOfDir64LocatorSig);
+			ZipWriter_put32(buf, 0); // disk with zip64 record
+			ZipWriter_put64(buf, eocd64);
+			ZipWriter_put32(buf, 1); // number of disks
+		}
+
+		ZipWriter_put32(buf, ZipWriterEndOfDirSig);
+		ZipWriter_put16(buf, 0); // disk
+		ZipWriter_put16(buf, 0); // disk with central directory
+		ZipWriter_put16(buf, uint16_t(std::min(count, ZipWriterMax16)));
+		ZipWriter_put16(buf, uint16_t(std::min(count, ZipWriterMax16)));
+		ZipWriter_put32(buf, uint32_t(std::min(cdSize, ZipWriterMax32)));
+		ZipWriter_put32(buf, uint32_t(std::min(cdOffset, ZipWriterMax32)));
+		ZipWriter_put16(buf, 0); // comment
+
+		return write(BytesView(buf));
+	}
+};
+
+static Rc<ZipWriterEntry> ZipWriter_makeEntry(StringView name, Time mtime, int level) {
+	auto entry = Rc<ZipWriterEntry>::alloc();
+	entry->name = name.str<memory::StandartInterface>();
+	entry->level = level;
+
+	// same as libzip: DOS time is a local time, starting from 1980
+	auto tm = mtime.asLocal();
+	if (tm.tm_year < 80) {
+		entry->dosDate = (1 << 5) | 1;
+	} else {
+		entry->dosTime = uint16_t((tm.tm_hour << 11) | (tm.tm_min << 5) | (tm.tm_sec >> 1));
+		entry->dosDate =
+				uint16_t(((tm.tm_year - 80) << 9) | ((tm.tm_mon + 1) << 5) | tm.tm_mday);
+	}
+	return entry;
+}
+
+ZipWriter::ZipWriter(const io::Consumer &consumer) : ZipWriter(consumer, Config()) { }
+
+ZipWriter::ZipWriter(const io::Consumer &consumer, const Config &cfg)
+: _data(new Data(consumer, cfg)) { }
+
+ZipWriter::ZipWriter(FILE *file) : ZipWriter(file, Config()) { }
+
+ZipWriter::ZipWriter(FILE *file, const Config &cfg)
+: _data(new Data(file, cfg)) { }
+
+ZipWriter::~ZipWriter() {
+	finalize();
+	delete _data;
+}
+
+bool ZipWriter::addDir(StringView name, Time mtime) {
+	auto entry = ZipWriter_makeEntry(name, mtime, _data->config.level);
+	if (!name.ends_with("/")) {
+		entry->name.push_back('/');
+	}
+	entry->isDir = true;
+	entry->uncompressed = true;
+	return _data->add(move(entry));
+}
+
+bool ZipWriter::addFile(StringView name, BytesView data, bool uncompressed, Time mtime) {
+	auto entry = ZipWriter_makeEntry(name, mtime, _data->config.level);
+	entry->input.assign(data.data(), data.data() + data.size());
+	entry->uncompressed = uncompressed;
+	return _data->add(move(entry));
+}
+
+bool ZipWriter::addFile(StringView name, StringView data, bool uncompressed, Time mtime) {
+	return addFile(name, BytesView((const uint8_t *)data.data(), data.size()), uncompressed,
+			mtime);
+}
+
+bool ZipWriter::finalize() {
+	if (_data->finalized) {
+		return !_data->failed;
+	}
+
+	_data->finalized = true;
+
+	if (!_data->flush(true) || !_data->writeCentralDirectory()) {
+		return false;
+	}
+
+	if (_data->file) {
+		::fflush(_data->file);
+	} else if (_data->consumer->flush_ptr) {
+		_data->consumer->flush();
+	}
+
+	return true;
+}
+
+ZipWriter::operator bool() const { return !_data->failed; }
+
+uint64_t ZipWriter::getWrittenSize() const { return _data->offset; }
+
+} // namespace STAPPLER_VERSIONIZED stappler